@@ -2,42 +2,414 @@
 
 using namespace s21;
 
-Facade::Facade(QObject* parent) : QObject(parent) {}
+Facade::Facade(QObject* parent)
+    : QObject(parent),
+      linesGeometry(new LinesGeometry()),
+      pointsGeometry(new LinesGeometry()) {
+  // Представления удаляются вместе с фасадом, а не сборщиком мусора QML
+  linesGeometry->setParent(this);
+  pointsGeometry->setParent(this);
+  pointsGeometry->setPrimitive(QQuick3DGeometry::PrimitiveType::Points);
+
+  connect(&loader, &ModelLoader::loadProgress, this, &Facade::loadProgress);
+  connect(&loader, &ModelLoader::loadFailed, this, [this]() {
+    emit loadFailed();
+    releaseStreamGeometry();
+  });
+  connect(&loader, &ModelLoader::batchReady, this,
+          [this](std::shared_ptr<const ModelBatch> batch) {
+            appendBatch(*batch);
+          });
+  connect(&loader, &ModelLoader::modelReady, this,
+          [this](std::shared_ptr<Model3D> loaded) {
+            releaseModelTasks();
+            // Одна копия модели: фасад и фоновые задачи делят её
+            model = std::move(loaded);
+            transform = model->transform;
+            viewsStale = true;
+            emit modelLoaded();
+            emit transformChanged();
+            releaseStreamGeometry();
+            buildPickIndex(model);
+            buildLods(model);
+          });
+}
+
+Facade::~Facade() {
+  modelToken.cancel();
+  for (const TaskHandle& task : modelTasks) task.wait();
+}
 
 void Facade::loadModel(const QString& filePath) {
-  loader.loadModel(model, filePath);
+  loader.loadModelAsync(filePath);
+}
+
+void Facade::cancelLoading() { loader.cancel(); }
+
+void Facade::appendBatch(const ModelBatch& batch) {
+  if (!streamGeometry || batch.firstVertex == 0) {
+    // Нормализацию оцениваем по первой части модели
+    Vertex center;
+    float scaleFactor;
+    if (!Model3D::normalizationFor(batch.vertices, center, scaleFactor)) {
+      return;
+    }
+    releaseStreamGeometry();
+    streamGeometry = new LinesGeometry();
+    streamGeometry->beginStreaming(center, scaleFactor);
+    currentgeometry = streamGeometry;
+    emit streamingStarted();
+  }
+
+  streamGeometry->appendStreamed(batch.vertices, batch.lineIndices,
+                                 batch.polygonCount, batch.progress);
+  emit vertexCountChanged();
+  emit polygonCountChanged();
+}
+
+void Facade::releaseStreamGeometry() {
+  if (!streamGeometry) return;
+  if (currentgeometry == streamGeometry) currentgeometry = nullptr;
+  streamGeometry->deleteLater();
+  streamGeometry = nullptr;
 }
 
 void Facade::rotateModel(float angleX, float angleY, float angleZ) {
-  model.rotateModel(angleX, angleY, angleZ);
-  emit geometryUpdated();
+  transform.rotate(angleX, angleY, angleZ);
+  emit transformChanged();
+  cullChunks();
 }
 
 void Facade::shiftModel(float angleX, float angleY, float angleZ) {
-  model.shiftModel(angleX, angleY, angleZ);
-  emit geometryUpdated();
+  transform.shift(angleX, angleY, angleZ);
+  emit transformChanged();
+  cullChunks();
+}
+
+QQuaternion Facade::modelRotation() const {
+  // Поворот и сдвиг не масштабируют модель, поэтому линейная часть
+  // матрицы — чистый поворот
+  const AffineTransform& matrix = transform.matrix();
+  QMatrix3x3 rotation;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) rotation(i, j) = matrix.m[i][j];
+  }
+  return QQuaternion::fromRotationMatrix(rotation);
+}
+
+QVector3D Facade::modelPosition() const {
+  const AffineTransform& matrix = transform.matrix();
+  return QVector3D(matrix.m[0][3], matrix.m[1][3], matrix.m[2][3]);
+}
+
+std::vector<Vertex> Facade::bakedVertices() const {
+  return model->bakedVertices(transform.matrix());
+}
+
+void Facade::rebuildViews() {
+  bool split = splitLargeModels &&
+               !LinesGeometry::shortIndicesFor(model->vertices.size());
+
+  // Индексы рёбер строятся задачей пула, пока упаковываются вершины
+  QByteArray indexData;
+  std::vector<LineChunk> chunks;
+  TaskHandle indexTask = ThreadPool::instance().submit(
+      [this, split, &indexData, &chunks]() {
+        if (split) {
+          chunks = clusterLines(model->vertices,
+                                convertToUniqueLines(model->polygons));
+        } else {
+          indexData = LinesGeometry::packLineIndices(model->polygons,
+                                                     model->vertices.size());
+        }
+      },
+      TaskPriority::kInteractive);
+  QByteArray vertexData = LinesGeometry::packVertices(model->vertices);
+  indexTask.wait();
+  pointsGeometry->updateGeometry(*model, vertexData);
+
+  for (LinesGeometry* chunk : chunkGeometries) chunk->deleteLater();
+  chunkGeometries.clear();
+  chunkBounds.clear();
+  chunkVisibility.clear();
+  if (split && !chunks.empty()) {
+    // Основная геометрия без рёбер: только счётчики вершин и полигонов
+    linesGeometry->updateChunk(*model, LineChunk());
+    for (const LineChunk& cluster : chunks) {
+      LinesGeometry* chunk = new LinesGeometry();
+      chunk->setParent(this);
+      chunk->updateChunk(*model, cluster);
+      chunkGeometries.append(chunk);
+      chunkBounds.push_back(cluster.bounds);
+      chunkVisibility.append(true);
+    }
+  } else {
+    linesGeometry->updateGeometry(*model, vertexData, indexData);
+  }
+  viewsStale = false;
+  emit lineChunksChanged();
+  cullChunks();
+  emit lineChunkVisibilityChanged();
+}
+
+void Facade::setSplitLargeModels(bool split) {
+  if (split == splitLargeModels) return;
+  splitLargeModels = split;
+  viewsStale = true;
+}
+
+QList<QObject*> Facade::lineChunks() const {
+  QList<QObject*> chunks;
+  if (currentLod > 0) return chunks;  // Упрощённый уровень не делится
+  for (LinesGeometry* chunk : chunkGeometries) chunks.append(chunk);
+  return chunks;
+}
+
+QList<bool> Facade::lineChunkVisibility() const { return chunkVisibility; }
+
+void Facade::updateCulling(const QVector3D& cameraPosition,
+                           const QQuaternion& cameraRotation,
+                           float fieldOfView, float viewportWidth,
+                           float viewportHeight) {
+  cameraView = CameraView{true, cameraPosition, cameraRotation, fieldOfView,
+                          viewportWidth, viewportHeight};
+  cullChunks();
+}
+
+void Facade::cullChunks() {
+  if (!cameraView.known || chunkBounds.empty()) return;
+
+  // Модель -> сцена (масштаб узла поверх transform) -> камера
+  AffineTransform sceneFromCamera;
+  QMatrix3x3 rotation = cameraView.rotation.toRotationMatrix();
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) sceneFromCamera.m[i][j] = rotation(i, j);
+    sceneFromCamera.m[i][3] = cameraView.position[i];
+  }
+  AffineTransform cameraFromModel =
+      sceneFromCamera.inverse() * AffineTransform::scaling(lodView.scale) *
+      transform.matrix();
+  Frustum frustum(cameraView.fieldOfView, cameraView.viewportWidth,
+                  cameraView.viewportHeight, cameraFromModel);
+
+  bool changed = false;
+  for (size_t i = 0; i < chunkBounds.size(); ++i) {
+    bool visible = frustum.intersects(chunkBounds[i]);
+    if (chunkVisibility[i] != visible) {
+      chunkVisibility[i] = visible;
+      changed = true;
+    }
+  }
+  if (changed) emit lineChunkVisibilityChanged();
 }
 
 LinesGeometry* Facade::createLinesView() {
-  auto geometry = new LinesGeometry();
-  geometry->updateGeometry(model);
-  geometry->updateVertices(model);
-  geometry->setPrimitiveType(QQuick3DGeometry::PrimitiveType::Lines);
-  currentgeometry = geometry;
+  if (viewsStale) rebuildViews();
+  ensureLodViews(currentLod);
+  currentgeometry = currentLod > 0 ? lodLines[currentLod - 1] : linesGeometry;
   emit vertexCountChanged();
   emit polygonCountChanged();
-  return geometry;
+  return currentgeometry;
 }
 
 LinesGeometry* Facade::createVerticesView() {
-  auto geometry = new LinesGeometry();
-  geometry->updateVertices(model);
-  geometry->setPrimitiveType(QQuick3DGeometry::PrimitiveType::Points);
-  currentgeometry = geometry;
+  if (viewsStale) rebuildViews();
+  ensureLodViews(currentLod);
+  currentgeometry =
+      currentLod > 0 ? lodPoints[currentLod - 1] : pointsGeometry;
   emit vertexCountChanged();
-  return geometry;
+  return currentgeometry;
+}
+
+void Facade::buildLods(std::shared_ptr<const Model3D> source) {
+  if (source->polygons.size() < MeshLod::kMinFaces) return;
+
+  quint64 generation = modelGeneration;
+  CancellationToken token = modelToken;
+  submitModelTask([this, source, token, generation]() {
+    auto levels = std::make_shared<std::vector<Model3D>>();
+    if (!MeshLod::buildChain(*source, *levels, &token)) return;
+    if (levels->empty()) return;
+    std::vector<size_t> faceCounts = {
+        MeshLod::triangleCount(source->polygons)};
+    for (const Model3D& level : *levels) {
+      faceCounts.push_back(level.polygons.size());
+    }
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation, levels, faceCounts]() {
+          if (generation != modelGeneration) return;  // Модель сменилась
+          lodModels = levels;
+          lodFaceCounts = faceCounts;
+          selectLod();
+        },
+        Qt::QueuedConnection);
+  });
+}
+
+void Facade::buildPickIndex(std::shared_ptr<const Model3D> source) {
+  quint64 generation = modelGeneration;
+  CancellationToken token = modelToken;
+  submitModelTask([this, source, token, generation]() {
+    // Открытие другой модели отменяет построение между проходами, и
+    // прежняя модель не удерживается до конца обоих деревьев
+    auto edges = std::make_shared<Bvh>();
+    std::vector<int> lines = convertToUniqueLines(source->polygons);
+    if (token.cancelled()) return;
+    if (!edges->build(source->vertices, lines, &token)) return;
+    auto points = std::make_shared<Bvh>();
+    if (!points->buildPoints(source->vertices, &token)) return;
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation, edges, points]() {
+          if (generation != modelGeneration) return;
+          edgeIndex = edges;
+          pointIndex = points;
+        },
+        Qt::QueuedConnection);
+  });
+}
+
+void Facade::submitModelTask(std::function<void()> task) {
+  // Описатели завершённых задач больше не нужны
+  modelTasks.erase(
+      std::remove_if(modelTasks.begin(), modelTasks.end(),
+                     [](const TaskHandle& task) { return task.done(); }),
+      modelTasks.end());
+  modelTasks.push_back(ThreadPool::instance().submit(
+      std::move(task), TaskPriority::kBackground, modelToken));
+}
+
+void Facade::releaseModelTasks() {
+  // Задачи отменяются без ожидания: они работают со своей копией модели
+  modelToken.cancel();
+  modelToken = CancellationToken();
+  ++modelGeneration;
+  edgeIndex.reset();
+  pointIndex.reset();
+  for (LinesGeometry* view : lodLines) {
+    if (view) view->deleteLater();
+  }
+  for (LinesGeometry* view : lodPoints) {
+    if (view) view->deleteLater();
+  }
+  if (currentgeometry && (lodLines.contains(currentgeometry) ||
+                          lodPoints.contains(currentgeometry))) {
+    currentgeometry = nullptr;
+  }
+  lodLines.clear();
+  lodPoints.clear();
+  lodModels.reset();
+  lodFaceCounts.clear();
+  currentLod = 0;
+}
+
+void Facade::updateLod(float scale, float cameraDistance, float fieldOfView,
+                       float viewportHeight) {
+  lodView = LodView{true, scale, cameraDistance, fieldOfView, viewportHeight};
+  selectLod();
+  cullChunks();
+}
+
+int Facade::lodLevel() const { return static_cast<int>(currentLod); }
+
+void Facade::setPickView(QObject* view) { pickView = view; }
+
+QVariantMap Facade::pickAt(float x, float y) {
+  QVariantMap result{{"kind", QStringLiteral("none")}};
+  if (!pickView || !edgeIndex || !pointIndex || !lodView.known) return result;
+
+  // Точки луча: у камеры и на глубине модели; там же — радиус выбора
+  auto toScene = [this](QVector3D viewPoint, QVector3D& point) {
+    return QMetaObject::invokeMethod(pickView, "mapTo3DScene",
+                                     Q_RETURN_ARG(QVector3D, point),
+                                     Q_ARG(QVector3D, viewPoint));
+  };
+  float depth = lodView.cameraDistance;
+  QVector3D nearPoint, farPoint, sidePoint;
+  if (!toScene(QVector3D(x, y, 0), nearPoint) ||
+      !toScene(QVector3D(x, y, depth), farPoint) ||
+      !toScene(QVector3D(x + kPickRadius, y, depth), sidePoint)) {
+    return result;
+  }
+
+  // Узел сцены: масштаб узла поверх transform
+  float scale = lodView.scale;
+  AffineTransform toModel = transform.matrix().inverse() *
+                            AffineTransform::scaling(1.0f / scale);
+  Ray ray;
+  QVector3D direction = farPoint - nearPoint;
+  for (int axis = 0; axis < 3; ++axis) {
+    ray.origin[axis] = nearPoint[axis];
+    ray.direction[axis] = direction[axis];
+  }
+  ray = ray.transformed(toModel);
+  float radius = (sidePoint - farPoint).length() / scale;
+
+  Vertex picked;
+  BvhHit hit = pointIndex->closest(model->vertices, ray, radius);
+  if (hit.found) {
+    picked = model->vertices[hit.segment];
+    result["kind"] = QStringLiteral("vertex");
+    result["vertex"] = static_cast<int>(hit.segment);
+  } else {
+    hit = edgeIndex->closest(model->vertices, ray, radius);
+    if (!hit.found) return result;
+    auto edge = edgeIndex->segment(hit.segment);
+    const Vertex& from = model->vertices[edge[0]];
+    const Vertex& to = model->vertices[edge[1]];
+    Vertex offset = to - from;
+    offset *= hit.along;
+    picked = from + offset;
+    result["kind"] = QStringLiteral("edge");
+    result["from"] = edge[0];
+    result["to"] = edge[1];
+  }
+  AffineTransform toWorld =
+      AffineTransform::scaling(scale) * transform.matrix();
+  toWorld.apply(picked.x, picked.y, picked.z);
+  result["position"] = QVector3D(picked.x, picked.y, picked.z);
+  return result;
+}
+
+void Facade::selectLod() {
+  size_t level = 0;
+  if (lodModels && lodView.known) {
+    double size =
+        MeshLod::projectedSize(lodView.scale, lodView.cameraDistance,
+                               lodView.fieldOfView, lodView.viewportHeight);
+    level = MeshLod::levelFor(size, lodFaceCounts);
+  }
+  if (level == currentLod) return;
+  currentLod = level;
+  emit lodChanged();
+  emit lineChunksChanged();
 }
 
+void Facade::ensureLodViews(size_t level) {
+  if (level == 0 || !lodModels) return;
+  while (static_cast<size_t>(lodLines.size()) < lodModels->size()) {
+    lodLines.append(nullptr);
+    lodPoints.append(nullptr);
+  }
+  if (lodLines[level - 1]) return;
+
+  // Как в rebuildViews(): вершины уровня упаковываются один раз
+  const Model3D& lod = (*lodModels)[level - 1];
+  QByteArray vertexData = LinesGeometry::packVertices(lod.vertices);
+  LinesGeometry* lines = new LinesGeometry();
+  lines->setParent(this);
+  lines->updateGeometry(lod, vertexData);
+  LinesGeometry* points = new LinesGeometry();
+  points->setParent(this);
+  points->setPrimitive(QQuick3DGeometry::PrimitiveType::Points);
+  points->updateGeometry(lod, vertexData);
+  lodLines[level - 1] = lines;
+  lodPoints[level - 1] = points;
+}
+
+LinesGeometry* Facade::streamingView() const { return streamGeometry; }
+
 int Facade::vertexCount() const {
   if (currentgeometry)
     return currentgeometry->vertexCount();
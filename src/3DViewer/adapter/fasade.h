@@ -15,10 +15,20 @@
 
 #include <QBuffer>
 #include <QDateTime>
+#include <QList>
 #include <QObject>
+#include <QPointer>
 #include <QProcess>
+#include <QQuaternion>
 #include <QQuickWindow>
+#include <QVariantMap>
+#include <QVector3D>
+#include <functional>
+#include <memory>
 
+#include "../core/bvh.h"
+#include "../core/frustum.h"
+#include "../core/meshlod.h"
 #include "../core/model3d.h"
 #include "linesgeometry.h"
 #include "modelloader.h"
@@ -41,9 +51,28 @@ namespace s21 {
  * Также отдаёт сигналы при изменении геометрии модели, которые могут
  * использоваться в пользовательском интерфейсе для обновления отображения
  * или статистики.
+ *
+ * Поворот и сдвиг не перезаписывают вершины: они накапливаются в
+ * ModelTransform фасада и передаются узлу сцены через свойства
+ * modelRotation и modelPosition, поэтому геометрию при этом перестраивать
+ * не нужно. Сама модель неизменяема и хранится в одном экземпляре, общем с
+ * фоновыми задачами (уровни детализации, BVH).
+ *
+ * Для плотных моделей после загрузки в фоне строится цепочка упрощённых
+ * уровней детализации (MeshLod); представления переключаются на уровень,
+ * подходящий размеру модели на экране (см. updateLod()). Там же строятся
+ * BVH рёбер и вершин для выбора элемента под курсором (pickAt()).
  */
 class Facade : public QObject {
   Q_OBJECT
+  Q_PROPERTY(QQuaternion modelRotation READ modelRotation NOTIFY
+                 transformChanged)
+  Q_PROPERTY(
+      QVector3D modelPosition READ modelPosition NOTIFY transformChanged)
+  Q_PROPERTY(
+      QList<QObject*> lineChunks READ lineChunks NOTIFY lineChunksChanged)
+  Q_PROPERTY(QList<bool> lineChunkVisibility READ lineChunkVisibility NOTIFY
+                 lineChunkVisibilityChanged)
  public:
   /**
    * @brief Конструктор класса Facade.
@@ -59,19 +88,32 @@ class Facade : public QObject {
    */
   explicit Facade(QObject* parent = nullptr);
 
+  /**
+   * @brief Отменяет фоновые задачи по модели и дожидается их.
+   */
+  ~Facade() override;
+
   /**
    * @brief Загружает 3D-модель из указанного файла.
    *
-   * Делегирует загрузку модели объекту `loader`, используя переданный путь.
+   * Делегирует загрузку модели объекту `loader`, который разбирает файл в
+   * фоновом потоке. Текущая модель остаётся на экране до сигнала
+   * modelLoaded(); незавершённая предыдущая загрузка отменяется.
    *
    * @param filePath Путь к .obj-файлу, содержащему 3D-модель.
    */
   Q_INVOKABLE void loadModel(const QString& filePath);
 
+  /**
+   * @brief Отменяет незавершённую загрузку модели.
+   */
+  Q_INVOKABLE void cancelLoading();
+
   /**
    * @brief Выполняет вращение загруженной модели вокруг трёх осей.
    *
-   * Применяет аффинное преобразование вращения к текущей 3D-модели
+   * Обновляет отложенное преобразование модели за O(1) и отдаёт сигнал
+   * transformChanged(); вершины не меняются.
    *
    * @param angleX Угол поворота вокруг оси X в градусах.
    * @param angleY Угол поворота вокруг оси Y в градусах.
@@ -82,8 +124,8 @@ class Facade : public QObject {
   /**
    * @brief Смещает модель вдоль трёх осей.
    *
-   * Применяет трансляцию к текущей модели в трёхмерном пространстве
-   * и отдаёт сигнал об обновлении геометрии.
+   * Обновляет отложенное преобразование модели за O(1) и отдаёт сигнал
+   * transformChanged(); вершины не меняются.
    *
    * @param angleX Смещение по оси X.
    * @param angleY Смещение по оси Y.
@@ -92,27 +134,149 @@ class Facade : public QObject {
   Q_INVOKABLE void shiftModel(float angleX, float angleY, float angleZ);
 
   /**
-   * @brief Создаёт и возвращает геометрию линий (ребер модели).
+   * @brief Поворот узла сцены, соответствующий преобразованию модели.
+   */
+  QQuaternion modelRotation() const;
+
+  /**
+   * @brief Положение узла сцены в координатах модели (без учёта масштаба
+   * узла) при нулевой точке pivot.
+   */
+  QVector3D modelPosition() const;
+
+  /**
+   * @brief Вершины модели с применёнными поворотом и сдвигом.
+   *
+   * Преобразование применяется к копии вершин; используется для экспорта
+   * и вычислений на CPU.
+   */
+  std::vector<Vertex> bakedVertices() const;
+
+  /**
+   * @brief Возвращает геометрию линий (ребер модели).
    *
-   * Генерирует представление модели в виде линий (грани) и сохраняет его
-   * во внутреннем указателе `currentgeometry`. Также отдаёт сигналы
-   * об обновлении количества вершин и полигонов.
+   * Геометрия принадлежит фасаду и живёт всё время его работы; буферы
+   * строятся заново только после загрузки новой модели. Указатель
+   * сохраняется в `currentgeometry`, отдаются сигналы об обновлении
+   * количества вершин и полигонов.
    *
-   * @return Указатель на сгенерированную геометрию линий.
+   * @return Указатель на геометрию линий.
    */
   Q_INVOKABLE LinesGeometry* createLinesView();
 
   /**
-   * @brief Создаёт и возвращает геометрию только вершин модели.
+   * @brief Возвращает геометрию только вершин модели.
    *
-   * Генерирует представление модели в виде только вершин (точек),
-   * сохраняет результат в `currentgeometry`, и отдаёт сигналы
-   * об обновлении количества вершин и полигонов.
+   * Как и createLinesView(), возвращает долгоживущий объект фасада и
+   * перестраивает его только после загрузки новой модели; указатель
+   * сохраняется в `currentgeometry`, отдаётся сигнал об обновлении
+   * количества вершин.
    *
-   * @return Указатель на сгенерированную геометрию вершин.
+   * @return Указатель на геометрию вершин.
    */
   Q_INVOKABLE LinesGeometry* createVerticesView();
 
+  /**
+   * @brief Возвращает геометрию рёбер, наполняемую во время загрузки.
+   *
+   * Геометрия создаётся при первой части потоковой загрузки (см. сигнал
+   * streamingStarted()) и дополняется по мере чтения файла. После
+   * modelLoaded() или loadFailed() она удаляется, поэтому представления
+   * нужно построить заново.
+   *
+   * @return Указатель на геометрию или nullptr, если загрузка не потоковая.
+   */
+  Q_INVOKABLE LinesGeometry* streamingView() const;
+
+  /**
+   * @brief Включает деление рёбер больших моделей на кластеры.
+   *
+   * Если включено и у модели больше kMaxShortIndexVertices вершин, рёбра
+   * делятся на пространственно связные кластеры (clusterLines()) с
+   * 16-битными индексами, и все кластеры отдаются свойством lineChunks;
+   * геометрия createLinesView() тогда хранит только счётчики модели.
+   * Кластеры вне поля зрения камеры скрываются (см. updateCulling()).
+   * По умолчанию включено.
+   */
+  Q_INVOKABLE void setSplitLargeModels(bool split);
+
+  /**
+   * @brief Геометрии кластеров рёбер (см. setSplitLargeModels()); пустой
+   * список, если модель не делится.
+   */
+  QList<QObject*> lineChunks() const;
+
+  /**
+   * @brief Видимость кластеров lineChunks: false — кластер целиком вне поля
+   * зрения камеры.
+   */
+  QList<bool> lineChunkVisibility() const;
+
+  /**
+   * @brief Сообщает положение камеры для отсечения кластеров рёбер.
+   *
+   * Боксы кластеров проверяются пирамидой видимости (Frustum) в
+   * координатах модели; проверка повторяется при повороте и сдвиге модели
+   * и при смене масштаба (updateLod()). При изменении видимости отдаётся
+   * сигнал lineChunkVisibilityChanged().
+   *
+   * @param cameraPosition Положение камеры в сцене.
+   * @param cameraRotation Поворот камеры в сцене.
+   * @param fieldOfView Вертикальный угол обзора в градусах; 0 для
+   * ортографической камеры.
+   * @param viewportWidth, viewportHeight Размер области вывода в пикселях.
+   */
+  Q_INVOKABLE void updateCulling(const QVector3D& cameraPosition,
+                                 const QQuaternion& cameraRotation,
+                                 float fieldOfView, float viewportWidth,
+                                 float viewportHeight);
+
+  /**
+   * @brief Сообщает параметры вида для выбора уровня детализации.
+   *
+   * Уровень выбирается MeshLod::levelFor() по размеру модели на экране;
+   * исходная модель показывается только при достаточном приближении. При
+   * смене уровня (и когда построенные в фоне уровни становятся доступны)
+   * отдаётся сигнал lodChanged().
+   *
+   * @param scale Масштаб узлов модели (ползунок масштаба).
+   * @param cameraDistance Расстояние от камеры до модели.
+   * @param fieldOfView Вертикальный угол обзора камеры в градусах; 0 для
+   * ортографической камеры.
+   * @param viewportHeight Высота области вывода в пикселях.
+   */
+  Q_INVOKABLE void updateLod(float scale, float cameraDistance,
+                             float fieldOfView, float viewportHeight);
+
+  /**
+   * @brief Номер показываемого уровня детализации (0 — исходная модель).
+   */
+  Q_INVOKABLE int lodLevel() const;
+
+  /**
+   * @brief Задаёт View3D, по которому pickAt() переводит координаты
+   * курсора в луч сцены (метод mapTo3DScene()).
+   */
+  Q_INVOKABLE void setPickView(QObject* view);
+
+  /**
+   * @brief Выбирает вершину или ребро модели под курсором.
+   *
+   * Луч из камеры через точку (x, y) переводится в координаты модели, и в
+   * BVH ищется ближайшая к нему вершина, а если её нет — ребро на
+   * расстоянии до kPickRadius пикселей. Выбор ведётся по исходной модели,
+   * даже если показан упрощённый уровень детализации. До построения BVH
+   * (сразу после загрузки) ничего не выбирается.
+   *
+   * @param x, y Координаты курсора в области вывода View3D.
+   * @return Словарь: kind — "vertex", "edge" или "none"; vertex — номер
+   * вершины; from, to — вершины ребра; position — выбранная точка в
+   * координатах сцены.
+   */
+  Q_INVOKABLE QVariantMap pickAt(float x, float y);
+
+  static constexpr float kPickRadius = 6.0f;  ///< Радиус выбора в пикселях
+
   /**
    * @brief Возвращает количество вершин в текущей геометрии.
    *
@@ -173,18 +337,170 @@ class Facade : public QObject {
   void polygonCountChanged();
 
   /**
-   * @brief Сигнал об обновлении геометрии модели.
+   * @brief Сигнал об изменении поворота или сдвига модели.
    *
-   * Эмитируется после трансформации модели (поворот или сдвиг),
-   * чтобы уведомить интерфейс о необходимости обновить отрисовку.
+   * Вершины при этом не меняются: достаточно обновить modelRotation и
+   * modelPosition узла сцены.
    */
-  void geometryUpdated();
+  void transformChanged();
+
+  /**
+   * @brief Сигнал об изменении списка lineChunks.
+   */
+  void lineChunksChanged();
+
+  /**
+   * @brief Сигнал об изменении lineChunkVisibility.
+   */
+  void lineChunkVisibilityChanged();
+
+  /**
+   * @brief Сигнал о смене уровня детализации: представления нужно получить
+   * заново через createLinesView() и createVerticesView().
+   */
+  void lodChanged();
+
+  /**
+   * @brief Сигнал о прогрессе фоновой загрузки модели.
+   *
+   * @param progress Доля обработанных байтов файла в диапазоне [0, 1].
+   */
+  void loadProgress(double progress);
+
+  /**
+   * @brief Сигнал о начале потокового отображения загружаемой модели.
+   *
+   * Эмитируется один раз за загрузку, когда готова streamingView().
+   */
+  void streamingStarted();
+
+  /**
+   * @brief Сигнал о завершении загрузки модели.
+   *
+   * Эмитируется в GUI-потоке, когда новая модель заменила текущую и по ней
+   * можно строить представления.
+   */
+  void modelLoaded();
+
+  /**
+   * @brief Сигнал об ошибке загрузки модели.
+   */
+  void loadFailed();
 
  private:
   Saver saver;
   LinesGeometry* currentgeometry = nullptr;
-  Model3D model;
+  LinesGeometry* linesGeometry;  ///< Представление рёбер (дочерний объект)
+  LinesGeometry* pointsGeometry;  ///< Представление вершин (дочерний объект)
+  bool viewsStale = true;  ///< Представления построены не по текущей модели
+  bool splitLargeModels = true;  ///< Делить рёбра больших моделей на части
+  QList<LinesGeometry*> chunkGeometries;  ///< Кластеры рёбер
+  std::vector<BoundingBox> chunkBounds;   ///< Боксы кластеров
+  QList<bool> chunkVisibility;            ///< Кластер в поле зрения
+  LinesGeometry* streamGeometry = nullptr;  ///< Превью потоковой загрузки
+  std::shared_ptr<const Model3D> model =
+      std::make_shared<const Model3D>();  ///< Модель, общая с задачами
+  ModelTransform transform;  ///< Поворот и сдвиг модели на узле сцены
   ModelLoader loader;
+
+  /**
+   * @brief Параметры вида, переданные в updateLod().
+   */
+  struct LodView {
+    bool known = false;  ///< updateLod() уже вызывался
+    float scale = 1.0f;
+    float cameraDistance = 1.0f;
+    float fieldOfView = 0.0f;
+    float viewportHeight = 0.0f;
+  };
+
+  LodView lodView;  ///< Последние параметры вида (и для pickAt())
+
+  /**
+   * @brief Камера, переданная в updateCulling().
+   */
+  struct CameraView {
+    bool known = false;  ///< updateCulling() уже вызывался
+    QVector3D position;
+    QQuaternion rotation;
+    float fieldOfView = 0.0f;
+    float viewportWidth = 0.0f;
+    float viewportHeight = 0.0f;
+  };
+
+  CameraView cameraView;  ///< Последнее положение камеры
+  std::shared_ptr<const std::vector<Model3D>> lodModels;  ///< Уровни 1, 2, ...
+  std::vector<size_t> lodFaceCounts;  ///< Треугольники уровней, начиная с 0
+  size_t currentLod = 0;               ///< Показываемый уровень
+  QList<LinesGeometry*> lodLines;      ///< Рёбра уровней 1, 2, ... (лениво)
+  QList<LinesGeometry*> lodPoints;     ///< Вершины уровней 1, 2, ... (лениво)
+  std::shared_ptr<const Bvh> edgeIndex;   ///< BVH рёбер модели
+  std::shared_ptr<const Bvh> pointIndex;  ///< BVH вершин модели
+  QPointer<QObject> pickView;             ///< View3D для pickAt()
+  CancellationToken modelToken;           ///< Отмена задач по модели
+  std::vector<TaskHandle> modelTasks;     ///< Фоновые задачи по модели
+  quint64 modelGeneration = 0;            ///< Номер актуальной модели
+
+  /**
+   * @brief Добавляет часть загружаемой модели в превью, создавая его при
+   * первой части.
+   */
+  void appendBatch(const ModelBatch& batch);
+
+  /**
+   * @brief Удаляет превью потоковой загрузки.
+   */
+  void releaseStreamGeometry();
+
+  /**
+   * @brief Перестраивает оба представления по текущей модели.
+   *
+   * Вершины упаковываются один раз: представление точек и представление
+   * рёбер получают один и тот же буфер, рёбра добавляют к нему только
+   * индексы.
+   */
+  void rebuildViews();
+
+  /**
+   * @brief Ставит в пул фоновое построение уровней детализации модели.
+   *
+   * @param source Загруженная модель; задача держит её указатель, так что
+   * текущую модель можно заменять, не дожидаясь задачи.
+   */
+  void buildLods(std::shared_ptr<const Model3D> source);
+
+  /**
+   * @brief Строит в пуле BVH рёбер и вершин модели для pickAt().
+   */
+  void buildPickIndex(std::shared_ptr<const Model3D> source);
+
+  /**
+   * @brief Ставит в пул фоновую задачу по текущей модели.
+   */
+  void submitModelTask(std::function<void()> task);
+
+  /**
+   * @brief Отменяет фоновые задачи по прежней модели и удаляет их
+   * результаты: уровни детализации и BVH.
+   */
+  void releaseModelTasks();
+
+  /**
+   * @brief Выбирает уровень по последним параметрам вида; при смене
+   * отдаёт lodChanged().
+   */
+  void selectLod();
+
+  /**
+   * @brief Пересчитывает видимость кластеров по последней камере; при
+   * изменении отдаёт lineChunkVisibilityChanged().
+   */
+  void cullChunks();
+
+  /**
+   * @brief Создаёт при первом обращении представления уровня level > 0.
+   */
+  void ensureLodViews(size_t level);
 };  // class facade
 
 }  // namespace s21
@@ -1,6 +1,11 @@
 #include "geometryadditions.h"
 
-std::vector<int> convertToTriangles(const std::vector<Polygon>& polygons) {
+namespace {
+
+// Общие реализации для std::vector<Polygon> и PolygonList
+
+template <typename Polygons>
+std::vector<int> trianglesOf(const Polygons& polygons) {
   std::vector<int> triangleIndices;
 
   for (const auto& polygon : polygons) {
@@ -32,6 +37,138 @@ std::vector<int> convertToTriangles(const std::vector<Polygon>& polygons) {
   return triangleIndices;
 }
 
+template <typename Polygons>
+std::vector<int> linesOf(const Polygons& polygons) {
+  std::vector<int> lineIndices;
+
+  for (const auto& polygon : polygons) {
+    appendPolygonLines(polygon, lineIndices);
+  }
+
+  return lineIndices;
+}
+
+/**
+ * @brief Вызывает visit(a, b) для каждого невырожденного ребра граней,
+ * упорядочив вершины ребра так, что a < b. Грани должны содержать хотя бы
+ * одну вершину.
+ */
+template <typename Polygons, typename Visit>
+void forEachEdge(const Polygons& polygons, Visit visit) {
+  for (const auto& polygon : polygons) {
+    // Ребро от последней вершины к первой замыкает грань
+    uint32_t previous = static_cast<uint32_t>(polygon[polygon.size() - 1]);
+    for (int index : polygon) {
+      uint32_t current = static_cast<uint32_t>(index);
+      if (previous < current) {
+        visit(previous, current);
+      } else if (current < previous) {
+        visit(current, previous);
+      }  // Вырожденное ребро (из вершины в неё же) не рисуется
+      previous = current;
+    }
+  }
+}
+
+constexpr size_t kUniqueLinesGrain =
+    size_t(1) << 14;  ///< Вершин в блоке параллельной очистки списков
+constexpr ptrdiff_t kInsertionSortLimit =
+    16;  ///< Списки не длиннее сортируются вставками
+
+/**
+ * @brief Сортирует концы рёбер одной вершины.
+ */
+void sortEnds(uint32_t* first, uint32_t* last) {
+  if (last - first < 2) return;
+  if (last - first > kInsertionSortLimit) {
+    std::sort(first, last);
+    return;
+  }
+  for (uint32_t* i = first + 1; i < last; ++i) {
+    uint32_t value = *i;
+    uint32_t* j = i;
+    for (; j > first && *(j - 1) > value; --j) *j = *(j - 1);
+    *j = value;
+  }
+}
+
+/**
+ * @brief Уникальные рёбра через сортировку подсчётом по меньшей вершине.
+ *
+ * Это поразрядная сортировка с одним разрядом шириной в индекс вершины:
+ * два последовательных прохода по граням (подсчёт и раскладка) дают для
+ * каждой вершины список больших концов её рёбер. Списки сортируются и
+ * очищаются от повторов параллельно в ThreadPool: короткие — вставками,
+ * длинные (вершины большой степени, например центр веера) — std::sort,
+ * так что время не растёт квадратично со степенью вершины. Память —
+ * 4 байта на вершину и на ребро, без хеш-таблицы и 64-битных ключей.
+ */
+template <typename Polygons>
+std::vector<int> uniqueLinesOf(const Polygons& polygons) {
+  uint32_t maxIndex = 0;
+  bool hasEdges = false;
+  for (const auto& polygon : polygons) {
+    if (polygon.size() < 2) {
+      throw std::runtime_error(
+          "Polygon must have at least 2 vertices to form lines.");
+    }
+    for (int index : polygon) {
+      maxIndex = std::max(maxIndex, static_cast<uint32_t>(index));
+    }
+    hasEdges = true;
+  }
+  if (!hasEdges) return {};
+
+  // Начало списка каждой вершины: подсчёт и префиксная сумма
+  std::vector<uint32_t> offsets(size_t(maxIndex) + 2, 0);
+  forEachEdge(polygons, [&](uint32_t a, uint32_t) { ++offsets[a + 1]; });
+  for (size_t v = 1; v < offsets.size(); ++v) offsets[v] += offsets[v - 1];
+
+  std::vector<uint32_t> ends(offsets.back());
+  std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+  forEachEdge(polygons, [&](uint32_t a, uint32_t b) { ends[cursor[a]++] = b; });
+
+  // Число уникальных концов каждой вершины, затем начало её рёбер в выходе
+  size_t vertexCount = size_t(maxIndex) + 1;
+  std::vector<uint32_t> unique(vertexCount + 1, 0);
+  ThreadPool& pool = ThreadPool::instance();
+  pool.parallelFor(vertexCount, kUniqueLinesGrain,
+                   [&](size_t begin, size_t end) {
+                     for (size_t a = begin; a < end; ++a) {
+                       uint32_t* first = ends.data() + offsets[a];
+                       uint32_t* last = ends.data() + offsets[a + 1];
+                       sortEnds(first, last);
+                       unique[a + 1] = static_cast<uint32_t>(
+                           std::unique(first, last) - first);
+                     }
+                   });
+  for (size_t v = 1; v < unique.size(); ++v) unique[v] += unique[v - 1];
+
+  std::vector<int> lineIndices(size_t(unique.back()) * 2);
+  pool.parallelFor(vertexCount, kUniqueLinesGrain,
+                   [&](size_t begin, size_t end) {
+                     for (size_t a = begin; a < end; ++a) {
+                       const uint32_t* first = ends.data() + offsets[a];
+                       int* out = lineIndices.data() + 2 * size_t(unique[a]);
+                       for (uint32_t i = unique[a]; i < unique[a + 1]; ++i) {
+                         *out++ = static_cast<int>(a);
+                         *out++ = static_cast<int>(*first++);
+                       }
+                     }
+                   });
+  return lineIndices;
+}
+
+}  // namespace
+
+std::vector<int> convertToTriangles(const std::vector<Polygon>& polygons) {
+  return trianglesOf(polygons);
+}
+
+std::vector<int> convertToTriangles(const PolygonList& polygons) {
+  return trianglesOf(polygons);
+}
+
 std::vector<int> convertTrianglesToLines(
     const std::vector<int>& triangleIndices) {
   std::vector<int> lineIndices;
@@ -55,28 +192,88 @@ std::vector<int> convertTrianglesToLines(
   return lineIndices;
 }
 
+void appendPolygonLines(PolygonView polygon, std::vector<int>& lineIndices) {
+  size_t numVertices = polygon.size();
+
+  if (numVertices < 2) {
+    // Полигон с менее чем 2 вершинами не может быть преобразован в линии
+    throw std::runtime_error(
+        "Polygon must have at least 2 vertices to form lines.");
+  }
+
+  // Создаем линии между последовательными вершинами
+  for (size_t i = 0; i < numVertices; ++i) {
+    int v0 = polygon[i];
+    int v1 = polygon[(i + 1) % numVertices];  // Замыкаем полигон (последняя
+                                              // вершина соединяется с первой)
+
+    lineIndices.push_back(v0);
+    lineIndices.push_back(v1);
+  }
+}
+
 std::vector<int> convertToLines(const std::vector<Polygon>& polygons) {
-  std::vector<int> lineIndices;
+  return linesOf(polygons);
+}
 
-  for (const auto& polygon : polygons) {
-    size_t numVertices = polygon.size();
+std::vector<int> convertToLines(const PolygonList& polygons) {
+  return linesOf(polygons);
+}
 
-    if (numVertices < 2) {
-      // Полигон с менее чем 2 вершинами не может быть преобразован в линии
-      throw std::runtime_error(
-          "Polygon must have at least 2 vertices to form lines.");
-    }
+std::vector<int> convertToUniqueLines(const std::vector<Polygon>& polygons) {
+  return uniqueLinesOf(polygons);
+}
 
-    // Создаем линии между последовательными вершинами
-    for (size_t i = 0; i < numVertices; ++i) {
-      int v0 = polygon[i];
-      int v1 = polygon[(i + 1) % numVertices];  // Замыкаем полигон (последняя
-                                                // вершина соединяется с первой)
+std::vector<int> convertToUniqueLines(const PolygonList& polygons) {
+  return uniqueLinesOf(polygons);
+}
 
-      lineIndices.push_back(v0);
-      lineIndices.push_back(v1);
+std::vector<LineChunk> clusterLines(const std::vector<Vertex>& vertices,
+                                    const std::vector<int>& lineIndices,
+                                    size_t maxEdges) {
+  if (maxEdges < 1 || maxEdges > kMaxShortIndexVertices / 2) {
+    throw std::invalid_argument("Invalid cluster size");
+  }
+  for (int index : lineIndices) {
+    if (index < 0 || static_cast<size_t>(index) >= vertices.size()) {
+      throw std::invalid_argument("Line index out of range");
     }
   }
 
-  return lineIndices;
-}
\ No newline at end of file
+  std::vector<uint32_t> order = Bvh::mortonOrder(vertices, lineIndices);
+  std::vector<LineChunk> clusters((order.size() + maxEdges - 1) / maxEdges);
+  ThreadPool::instance().parallelFor(
+      clusters.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+          LineChunk& cluster = clusters[c];
+          size_t first = c * maxEdges;
+          size_t last = std::min(order.size(), first + maxEdges);
+          for (size_t i = first; i < last; ++i) {
+            cluster.vertices.push_back(lineIndices[2 * order[i]]);
+            cluster.vertices.push_back(lineIndices[2 * order[i] + 1]);
+          }
+          std::sort(cluster.vertices.begin(), cluster.vertices.end());
+          cluster.vertices.erase(
+              std::unique(cluster.vertices.begin(), cluster.vertices.end()),
+              cluster.vertices.end());
+
+          // Локальный индекс — позиция вершины в отсортированном списке
+          cluster.indices.reserve(2 * (last - first));
+          for (size_t i = first; i < last; ++i) {
+            for (int k = 0; k < 2; ++k) {
+              int vertex = lineIndices[2 * order[i] + k];
+              auto position =
+                  std::lower_bound(cluster.vertices.begin(),
+                                   cluster.vertices.end(), vertex);
+              cluster.indices.push_back(static_cast<uint16_t>(
+                  position - cluster.vertices.begin()));
+            }
+          }
+          for (int vertex : cluster.vertices) {
+            const Vertex& v = vertices[vertex];
+            cluster.bounds.include(v.x, v.y, v.z);
+          }
+        }
+      });
+  return clusters;
+}
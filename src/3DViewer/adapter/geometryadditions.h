@@ -25,6 +25,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtGui/QGuiApplication>
 
+#include "../core/bvh.h"
 #include "../io/objloader.h"
 #include "model3d.h"
 
@@ -38,6 +39,13 @@ using namespace s21;
  */
 std::vector<int> convertToTriangles(const std::vector<Polygon>& polygons);
 
+/**
+ * @brief Преобразует грани модели в треугольники.
+ * @param polygons Грани модели.
+ * @return Вектор индексов треугольников.
+ */
+std::vector<int> convertToTriangles(const PolygonList& polygons);
+
 /**
  * @brief Преобразует полигоны в линии (ребра).
  * @param polygons Вектор полигонов.
@@ -45,6 +53,82 @@ std::vector<int> convertToTriangles(const std::vector<Polygon>& polygons);
  */
 std::vector<int> convertToLines(const std::vector<Polygon>& polygons);
 
+/**
+ * @brief Преобразует грани модели в линии (ребра).
+ * @param polygons Грани модели.
+ * @return Вектор индексов рёбер.
+ */
+std::vector<int> convertToLines(const PolygonList& polygons);
+
+/**
+ * @brief Преобразует полигоны в линии без повторяющихся рёбер.
+ *
+ * Общее ребро соседних граней выводится один раз, независимо от порядка
+ * вершин в гранях; вырожденные рёбра (из вершины в неё же) пропускаются.
+ * Рёбра упорядочены по индексам вершин, а не по граням.
+ *
+ * @param polygons Вектор полигонов.
+ * @return Вектор индексов уникальных рёбер.
+ * @throw std::runtime_error если у полигона меньше 2 вершин.
+ */
+std::vector<int> convertToUniqueLines(const std::vector<Polygon>& polygons);
+
+/**
+ * @brief Преобразует грани модели в линии без повторяющихся рёбер.
+ * @param polygons Грани модели.
+ * @return Вектор индексов уникальных рёбер.
+ * @throw std::runtime_error если у грани меньше 2 вершин.
+ */
+std::vector<int> convertToUniqueLines(const PolygonList& polygons);
+
+/**
+ * @brief Наибольшее число вершин, адресуемых 16-битными индексами.
+ */
+constexpr size_t kMaxShortIndexVertices = 65536;
+
+/**
+ * @brief Часть рёбер модели со своим набором вершин и 16-битными индексами
+ * (кластер clusterLines()).
+ */
+struct LineChunk {
+  std::vector<int> vertices;      ///< Индексы вершин модели
+  std::vector<uint16_t> indices;  ///< Пары локальных индексов (в vertices)
+  BoundingBox bounds;             ///< Бокс вершин части
+};
+
+/**
+ * @brief Рёбер в кластере clusterLines() по умолчанию.
+ */
+constexpr size_t kClusterEdges = 1 << 14;
+
+/**
+ * @brief Делит рёбра на пространственно связные кластеры с боксами.
+ *
+ * Рёбра упорядочиваются по кодам Мортона центров (Bvh::mortonOrder()) и
+ * режутся на кластеры по maxEdges рёбер, так что каждый кластер занимает
+ * компактную область модели и его можно отбросить по боксу (Frustum).
+ * Вершин в кластере не больше 2 * maxEdges, поэтому индексы 16-битные.
+ * Кластеры собираются параллельно в ThreadPool.
+ *
+ * @param vertices Вершины модели.
+ * @param lineIndices Пары индексов рёбер.
+ * @param maxEdges Наибольшее число рёбер кластера.
+ * @return Кластеры; пустой вектор, если рёбер нет.
+ * @throw std::invalid_argument если maxEdges вне [1,
+ * kMaxShortIndexVertices / 2] или индекс вне массива вершин.
+ */
+std::vector<LineChunk> clusterLines(const std::vector<Vertex>& vertices,
+                                    const std::vector<int>& lineIndices,
+                                    size_t maxEdges = kClusterEdges);
+
+/**
+ * @brief Добавляет рёбра одного полигона в массив индексов линий.
+ * @param polygon Полигон.
+ * @param lineIndices Массив, в который добавляются пары индексов.
+ * @throw std::runtime_error если у полигона меньше 2 вершин.
+ */
+void appendPolygonLines(PolygonView polygon, std::vector<int>& lineIndices);
+
 /**x
  * @brief Преобразует треугольники в линии.
  * @param triangleIndices Индексы треугольников (по 3 на треугольник).
@@ -6,42 +6,49 @@ GeometryPrototype::GeometryPrototype(QQuick3DObject *parent)
     : QQuick3DGeometry(parent) {}
 
 void GeometryPrototype::setupGeometry() {
-  m_indexData.clear();  // Очищаем предыдущую геометрию
-
-  // Установка данных индексов
-  populateIndexData();
-  setIndexData(m_indexData);
-
-  // Добавление атрибута индексов
-  addAttribute(
-      QQuick3DGeometry::Attribute::IndexSemantic,
-      0,                                      // Offset
-      QQuick3DGeometry::Attribute::U32Type);  // Тип данных для индексов
-
-  // Установка границ модели
-  setBounds(QVector3D(-1, -1, -1), QVector3D(1, 1, 1));
-
-  update();  // Обновление геометрии
-}
-
-void GeometryPrototype::setupVertices() {
+  clear();  // Очищаем атрибуты и буферы предыдущей геометрии
   m_vertexData.clear();
+  m_indexData.clear();
 
-  // Создаем массив вершин
+  // Атрибут вершин: только позиция, как в s21::Vertex
   addAttribute(QQuick3DGeometry::Attribute::PositionSemantic,
                0,                                      // Offset
                QQuick3DGeometry::Attribute::F32Type);  // Тип данных
-  addAttribute(QQuick3DGeometry::Attribute::TexCoord0Semantic,
-               3 * sizeof(float), QQuick3DGeometry::Attribute::F32Type);  // UV
   // Установка шага для атрибута позиций вершин
-  setStride(sizeof(float) * 5);  // Шаг равен размеру одной вершины (3 float)
+  setStride(sizeof(float) * 3);  // Шаг равен размеру одной вершины (3 float)
 
   // Установка данных вершин
   populateVertexData();
   setVertexData(m_vertexData);
 
-  //  Установка границ модели
-  setBounds(QVector3D(-1, -1, -1), QVector3D(1, 1, 1));
+  if (m_primitive != QQuick3DGeometry::PrimitiveType::Points) {
+    // Установка данных индексов
+    populateIndexData();
+    setIndexData(m_indexData);
+
+    // Добавление атрибута индексов (U16 или U32, см. m_indexType)
+    addAttribute(QQuick3DGeometry::Attribute::IndexSemantic,
+                 0,             // Offset
+                 m_indexType);  // Тип данных для индексов
+  }
+  setPrimitiveType(m_primitive);
 
+  // Установка границ модели
+  setBounds(m_boundsMin, m_boundsMax);
+
+  update();  // Обновление геометрии
+}
+
+void GeometryPrototype::setupVertices() {
+  // Буфер перезаписывается на месте, индексы не пересчитываются
+  populateVertexData();
+  setVertexData(m_vertexData);
+  setBounds(m_boundsMin, m_boundsMax);
   update();
+}
+
+void GeometryPrototype::setPrimitive(
+    QQuick3DGeometry::PrimitiveType primitive) {
+  m_primitive = primitive;
+  setPrimitiveType(primitive);
 }
\ No newline at end of file
@@ -31,23 +31,40 @@ class GeometryPrototype : public QQuick3DGeometry {
 
   /**
    * @brief Полная настройка геометрии: вершины, индексы, атрибуты.
+   *
+   * Прежние атрибуты и буферы сбрасываются, поэтому объект можно
+   * переиспользовать для новой модели. Для точек индексы не строятся.
    */
   void setupGeometry();
 
   /**
-   * @brief Настройка только вершинной геометрии (например, для отображения
-   * точек).
+   * @brief Обновляет только буфер вершин; атрибуты и индексы остаются
+   * прежними. Геометрия должна быть настроена setupGeometry().
    */
   void setupVertices();
 
+  /**
+   * @brief Задаёт тип примитивов (линии или точки).
+   */
+  void setPrimitive(QQuick3DGeometry::PrimitiveType primitive);
+
  protected:
   QByteArray m_vertexData;
   QByteArray m_indexData;
   QQuick3DGeometry::PrimitiveType m_primitive;
+  /// Тип индексов, выбранный в populateIndexData(): U16, если все вершины
+  /// адресуются 16-битными индексами, иначе U32
+  QQuick3DGeometry::Attribute::ComponentType m_indexType =
+      QQuick3DGeometry::Attribute::U32Type;
 
   int m_vertexCount = 0;
   int m_polygonCount = 0;
 
+  // Границы вершин для setBounds() задаются в populateVertexData(); по ним
+  // Qt Quick 3D отсекает модель вне поля зрения
+  QVector3D m_boundsMin{-1, -1, -1};  ///< Минимальный угол бокса вершин
+  QVector3D m_boundsMax{1, 1, 1};     ///< Максимальный угол бокса вершин
+
   /**
    * @brief Метод для заполнения массива данных вершин.
    */
@@ -7,40 +7,196 @@ LinesGeometry::LinesGeometry(QQuick3DObject* parent)
   m_primitive = QQuick3DGeometry::PrimitiveType::Lines;
 }
 
-void LinesGeometry::updateGeometry(const Model3D& model) {
+void LinesGeometry::updateGeometry(const Model3D& model,
+                                   const QByteArray& vertexData,
+                                   const QByteArray& indexData) {
   m_model = &model;  // Сохраняем ссылку на модель
-  setupGeometry();   // Вызываем настройку геометрии
+  m_pendingVertexData = vertexData;
+  m_pendingIndexData = indexData;
+  m_chunked = false;
+  m_chunk = LineChunk();
+  setupGeometry();  // Вызываем настройку геометрии
 }
 
-void LinesGeometry::updateVertices(const Model3D& model) {
+void LinesGeometry::updateVertices(const Model3D& model,
+                                   const QByteArray& vertexData) {
   m_model = &model;  // Сохраняем ссылку на модель
-  setupVertices();   // Вызываем настройку вершин
+  m_pendingVertexData = vertexData;
+  setupVertices();  // Вызываем настройку вершин
+}
+
+void LinesGeometry::updateChunk(const Model3D& model, const LineChunk& chunk) {
+  m_model = &model;
+  m_pendingVertexData.clear();
+  m_pendingIndexData.clear();
+  m_chunk = chunk;
+  m_chunked = true;
+  setupGeometry();
+}
+
+QByteArray LinesGeometry::packVertices(const std::vector<Vertex>& vertices) {
+  const char* source = reinterpret_cast<const char*>(vertices.data());
+  QByteArray data(vertices.size() * sizeof(Vertex), Qt::Uninitialized);
+  char* target = data.data();
+  ThreadPool::instance().parallelFor(
+      data.size(), kPackGrain, [&](size_t begin, size_t end) {
+        memcpy(target + begin, source + begin, end - begin);
+      });
+  return data;
+}
+
+QByteArray LinesGeometry::packLineIndices(const PolygonList& polygons,
+                                          size_t vertexCount) {
+  std::vector<int> indices = convertToUniqueLines(polygons);
+  if (!shortIndicesFor(vertexCount)) {
+    return QByteArray(reinterpret_cast<const char*>(indices.data()),
+                      indices.size() * sizeof(int));
+  }
+  // Вдвое меньший буфер: все индексы помещаются в 16 бит
+  QByteArray data(indices.size() * sizeof(uint16_t), Qt::Uninitialized);
+  uint16_t* target = reinterpret_cast<uint16_t*>(data.data());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    target[i] = static_cast<uint16_t>(indices[i]);
+  }
+  return data;
+}
+
+void LinesGeometry::beginStreaming(const Vertex& center, float scaleFactor) {
+  m_model = nullptr;
+  m_streamCenter = center;
+  m_streamScale = scaleFactor;
+  m_vertexCount = 0;
+  m_polygonCount = 0;
+  m_vertexData.clear();
+  m_indexData.clear();
+  m_streamVertexBytes = 0;
+  m_streamIndexBytes = 0;
+  m_streamBounds = BoundingBox();
+
+  clear();
+  addAttribute(QQuick3DGeometry::Attribute::PositionSemantic, 0,
+               QQuick3DGeometry::Attribute::F32Type);
+  addAttribute(QQuick3DGeometry::Attribute::IndexSemantic, 0,
+               QQuick3DGeometry::Attribute::U32Type);
+  setStride(sizeof(Vertex));
+  setPrimitiveType(m_primitive);
+  setBounds(QVector3D(-1, -1, -1), QVector3D(1, 1, 1));
+  update();
+}
+
+void LinesGeometry::appendStreamed(const std::vector<Vertex>& vertices,
+                                   const std::vector<int>& lineIndices,
+                                   size_t polygonCount, double progress) {
+  // Новые вершины нормализуются в буфер размером с часть
+  QByteArray vertexTail(vertices.size() * sizeof(Vertex), Qt::Uninitialized);
+  float* vertexPtr = reinterpret_cast<float*>(vertexTail.data());
+  VertexKernels::transform(
+      AffineTransform::scaling(m_streamScale) *
+          AffineTransform::translation(-m_streamCenter.x, -m_streamCenter.y,
+                                       -m_streamCenter.z),
+      reinterpret_cast<const float*>(vertices.data()), vertexPtr,
+      vertices.size());
+  m_streamBounds.merge(VertexKernels::bounds(vertexPtr, vertices.size()));
+  setBoundsFrom(m_streamBounds);
+  m_vertexCount += static_cast<int>(vertices.size());
+  m_polygonCount += static_cast<int>(polygonCount);
+  QByteArray indexTail = QByteArray::fromRawData(
+      reinterpret_cast<const char*>(lineIndices.data()),
+      lineIndices.size() * sizeof(int));
+
+  // Буфер геометрии увеличивается редко; обычно передаётся только хвост.
+  // Своей копии буфера не держим, чтобы запись хвоста не отделяла его
+  qsizetype vertexOffset = m_streamVertexBytes;
+  m_streamVertexBytes += vertexTail.size();
+  QByteArray buffer = vertexData();
+  if (m_streamVertexBytes > buffer.size()) {
+    buffer.resize(streamCapacity(m_streamVertexBytes, buffer.size(), progress,
+                                 sizeof(Vertex)));
+    setVertexData(buffer);
+  }
+  buffer = QByteArray();
+  setVertexData(vertexOffset, vertexTail);
+
+  qsizetype indexOffset = m_streamIndexBytes;
+  m_streamIndexBytes += indexTail.size();
+  buffer = indexData();
+  if (m_streamIndexBytes > buffer.size()) {
+    buffer.resize(streamCapacity(m_streamIndexBytes, buffer.size(), progress,
+                                 2 * sizeof(int)));
+    memset(buffer.data() + indexOffset, 0, buffer.size() - indexOffset);
+    setIndexData(buffer);
+  }
+  buffer = QByteArray();
+  setIndexData(indexOffset, indexTail);
+
+  setBounds(m_boundsMin, m_boundsMax);
+  update();
+}
+
+qsizetype LinesGeometry::streamCapacity(qsizetype used, qsizetype allocated,
+                                        double progress, qsizetype unit) {
+  double estimate = progress > 0.0 ? kStreamSlack * used / progress : 0.0;
+  estimate = std::max(estimate, kStreamGrowth * allocated);
+  // Смещения в setVertexData() и setIndexData() — int
+  estimate = std::min(estimate, double(std::numeric_limits<int>::max()));
+  qsizetype capacity = std::max(used, static_cast<qsizetype>(estimate));
+  return (capacity + unit - 1) / unit * unit;
+}
+
+void LinesGeometry::setBoundsFrom(const BoundingBox& box) {
+  if (box.empty()) {
+    m_boundsMin = m_boundsMax = QVector3D(0, 0, 0);
+    return;
+  }
+  m_boundsMin = QVector3D(box.min[0], box.min[1], box.min[2]);
+  m_boundsMax = QVector3D(box.max[0], box.max[1], box.max[2]);
 }
 
 void LinesGeometry::populateVertexData() {
   if (!m_model) return;
 
-  // Создание массива вершин
-  m_vertexData.resize(m_model->vertices.size() * 5 * sizeof(float));
-  float* vertexPtr = reinterpret_cast<float*>(m_vertexData.data());
-  for (const auto& vertex : m_model->vertices) {
-    *vertexPtr++ = vertex.x;
-    *vertexPtr++ = vertex.y;
-    *vertexPtr++ = vertex.z;
-    *vertexPtr++ = vertex.x;
-    *vertexPtr++ = vertex.y;
-    m_vertexCount++;
+  if (m_chunked) {
+    // Только вершины части, в порядке локальных индексов
+    m_vertexData.resize(m_chunk.vertices.size() * sizeof(Vertex));
+    Vertex* target = reinterpret_cast<Vertex*>(m_vertexData.data());
+    for (size_t i = 0; i < m_chunk.vertices.size(); ++i) {
+      target[i] = m_model->vertices[m_chunk.vertices[i]];
+    }
+    m_vertexCount = static_cast<int>(m_model->vertices.size());
+    setBoundsFrom(VertexKernels::bounds(
+        reinterpret_cast<const float*>(target), m_chunk.vertices.size()));
+    return;
+  }
+
+  // Общий буфер берётся без копирования, иначе вершины упаковываются
+  if (m_pendingVertexData.isEmpty()) {
+    m_vertexData = packVertices(m_model->vertices);
+  } else {
+    m_vertexData = std::exchange(m_pendingVertexData, QByteArray());
   }
+  m_vertexCount = static_cast<int>(m_model->vertices.size());
+  setBoundsFrom(m_model->bounds());
 }
 
 void LinesGeometry::populateIndexData() {
   if (!m_model) return;
 
-  // Преобразование полигонов в треугольники
-  std::vector<int> indices = convertToLines(m_model->polygons);
-  m_polygonCount = indices.size() / 3;
+  m_polygonCount = static_cast<int>(m_model->polygons.size());
+  if (m_chunked) {
+    m_indexData = QByteArray(
+        reinterpret_cast<const char*>(m_chunk.indices.data()),
+        m_chunk.indices.size() * sizeof(uint16_t));
+    m_indexType = QQuick3DGeometry::Attribute::U16Type;
+    return;
+  }
 
-  // Создание массива индексов
-  m_indexData.resize(indices.size() * sizeof(int));
-  memcpy(m_indexData.data(), indices.data(), m_indexData.size());
+  // Рёбра без повторов общих рёбер: готовый буфер или строим заново
+  if (m_pendingIndexData.isEmpty()) {
+    m_indexData = packLineIndices(m_model->polygons, m_model->vertices.size());
+  } else {
+    m_indexData = std::exchange(m_pendingIndexData, QByteArray());
+  }
+  m_indexType = shortIndicesFor(m_model->vertices.size())
+                    ? QQuick3DGeometry::Attribute::U16Type
+                    : QQuick3DGeometry::Attribute::U32Type;
 }
\ No newline at end of file
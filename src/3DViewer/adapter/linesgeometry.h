@@ -12,8 +12,10 @@
 #include <QByteArray>
 #include <QQuick3DGeometry>
 #include <QVector3D>
+#include <utility>
 
 #include "../core/model3d.h"
+#include "../core/threadpool.h"
 #include "geometryadditions.h"
 #include "geometryprototype.h"
 
@@ -36,16 +38,114 @@ class LinesGeometry : public GeometryPrototype {
   explicit LinesGeometry(QQuick3DObject *parent = nullptr);
 
   /**
-   * @brief Обновляет геометрию модели (вершины и индексы).
+   * @brief Строит геометрию модели заново (вершины и индексы).
+   *
+   * Нужна только при смене топологии, то есть при загрузке новой модели.
+   *
    * @param model Модель, которую нужно отобразить.
+   * @param vertexData Упакованные вершины (packVertices()), общие с другим
+   * представлением; если пусто, вершины упаковываются заново.
+   * @param indexData Готовые индексы рёбер (packLineIndices()); если пусто,
+   * индексы строятся заново.
    */
-  void updateGeometry(const Model3D &model);
+  void updateGeometry(const Model3D &model,
+                      const QByteArray &vertexData = QByteArray(),
+                      const QByteArray &indexData = QByteArray());
 
   /**
    * @brief Обновляет только вершины модели (без пересоздания индексов).
+   *
+   * Топология модели должна совпадать с той, по которой вызывался
+   * updateGeometry().
+   *
    * @param model Модель, вершины которой нужно обновить.
+   * @param vertexData Упакованные вершины, как в updateGeometry().
    */
-  void updateVertices(const Model3D &model);
+  void updateVertices(const Model3D &model,
+                      const QByteArray &vertexData = QByteArray());
+
+  /**
+   * @brief Строит геометрию из одного кластера рёбер модели
+   * (clusterLines()).
+   *
+   * Буфер вершин содержит только вершины кластера, индексы 16-битные.
+   * Счётчики вершин и граней берутся по всей модели.
+   *
+   * @param model Модель, которой принадлежит часть.
+   * @param chunk Часть рёбер; копируется.
+   */
+  void updateChunk(const Model3D &model, const LineChunk &chunk);
+
+  /**
+   * @brief Копирует вершины в буфер формата геометрии без преобразования:
+   * формат буфера совпадает с массивом s21::Vertex (3 float на вершину).
+   *
+   * Большие массивы копируются блоками в потоках ThreadPool. QByteArray
+   * разделяется неявно, поэтому один буфер можно передать нескольким
+   * представлениям без копирования.
+   */
+  static QByteArray packVertices(const std::vector<Vertex> &vertices);
+
+  /**
+   * @brief Строит буфер индексов рёбер модели без повторов общих рёбер
+   * (convertToUniqueLines()).
+   *
+   * Индексы 16-битные, если vertexCount не больше kMaxShortIndexVertices
+   * (shortIndicesFor()), иначе 32-битные. Не обращается к геометрии,
+   * поэтому может выполняться задачей ThreadPool одновременно с упаковкой
+   * вершин.
+   *
+   * @param polygons Грани модели.
+   * @param vertexCount Число вершин модели.
+   */
+  static QByteArray packLineIndices(const PolygonList &polygons,
+                                    size_t vertexCount);
+
+  /**
+   * @brief Достаточно ли 16-битных индексов для vertexCount вершин.
+   */
+  static bool shortIndicesFor(size_t vertexCount) {
+    return vertexCount <= kMaxShortIndexVertices;
+  }
+
+  static constexpr qsizetype kPackGrain =
+      qsizetype(1) << 22;  ///< Минимальный блок параллельного копирования
+  static constexpr double kStreamSlack =
+      1.125;  ///< Запас буферов потоковой загрузки сверх оценки размера
+  static constexpr double kStreamGrowth =
+      1.5;  ///< Минимальный рост буфера, если оценка оказалась мала
+
+  /**
+   * @brief Готовит пустую геометрию для потокового наполнения.
+   *
+   * Пока модель загружается, вершины центрируются и масштабируются по
+   * оценке, полученной из первой части модели (см.
+   * Model3D::normalizationFor()); после загрузки геометрия строится заново
+   * по нормализованной модели.
+   *
+   * @param center Оценка центра модели.
+   * @param scaleFactor Оценка коэффициента масштабирования.
+   */
+  void beginStreaming(const Vertex &center, float scaleFactor);
+
+  /**
+   * @brief Дописывает в конец буферов очередную часть модели.
+   *
+   * Буферы выделяются с запасом по оценке итогового размера (загруженное
+   * / progress), и в них передаётся только новая часть
+   * (setVertexData(offset, data)), поэтому загрузка не копирует уже
+   * переданные данные заново. Незанятый хвост буфера индексов заполнен
+   * нулями — вырожденными рёбрами, которые не видны. Если оценка оказалась
+   * мала, буфер растёт не меньше чем в kStreamGrowth раз.
+   *
+   * @param vertices Новые вершины (ещё не нормализованные).
+   * @param lineIndices Пары абсолютных индексов новых рёбер.
+   * @param polygonCount Число новых граней.
+   * @param progress Доля файла, разобранная к концу части.
+   */
+  void appendStreamed(const std::vector<Vertex> &vertices,
+                      const std::vector<int> &lineIndices,
+                      size_t polygonCount, double progress);
 
   /**
    * @brief Возвращает количество вершин.
@@ -53,7 +153,7 @@ class LinesGeometry : public GeometryPrototype {
   int vertexCount() const { return m_vertexCount; }
 
   /**
-   * @brief Возвращает количество полигонов (ребер).
+   * @brief Возвращает количество полигонов (граней, а не рёбер).
    */
   int polygonCount() const { return m_polygonCount; }
 
@@ -64,7 +164,8 @@ class LinesGeometry : public GeometryPrototype {
   void populateVertexData() override;
 
   /**
-   * @brief Заполняет массив индексов линий.
+   * @brief Заполняет массив индексов линий; общие рёбра соседних граней
+   * выводятся один раз (convertToUniqueLines()).
    */
   void populateIndexData() override;
 
@@ -72,7 +173,31 @@ class LinesGeometry : public GeometryPrototype {
    * @brief Указатель на модель, используемую для генерации геометрии.
    */
   const Model3D *m_model = nullptr;  // Указатель на модель
-};                                   // class LinesGeometry
+
+  /**
+   * @brief Переносит бокс вершин в m_boundsMin и m_boundsMax.
+   */
+  void setBoundsFrom(const BoundingBox &box);
+
+  /**
+   * @brief Размер буфера потоковой загрузки, вмещающего used байт, с
+   * запасом по оценке итогового размера.
+   * @param allocated Текущий размер буфера.
+   * @param unit Размер элемента буфера (вершины или пары индексов).
+   */
+  static qsizetype streamCapacity(qsizetype used, qsizetype allocated,
+                                  double progress, qsizetype unit);
+
+  QByteArray m_pendingVertexData;  ///< Готовый буфер для populateVertexData()
+  QByteArray m_pendingIndexData;   ///< Готовый буфер для populateIndexData()
+  LineChunk m_chunk;       ///< Часть рёбер для updateChunk()
+  bool m_chunked = false;  ///< Геометрия построена по m_chunk
+  BoundingBox m_streamBounds;  ///< Бокс вершин, полученных при загрузке
+  Vertex m_streamCenter;       ///< Оценка центра при потоковой загрузке
+  float m_streamScale = 1.0f;  ///< Оценка масштаба при потоковой загрузке
+  qsizetype m_streamVertexBytes = 0;  ///< Занято в буфере вершин
+  qsizetype m_streamIndexBytes = 0;   ///< Занято в буфере индексов
+};                                    // class LinesGeometry
 
 }  // namespace s21
 
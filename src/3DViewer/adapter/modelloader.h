@@ -6,17 +6,53 @@
 #ifndef MODELLOADER_H
 #define MODELLOADER_H
 
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "../core/threadpool.h"
+#include "../io/meshcache.h"
 #include "../io/objloader.h"
+#include "geometryadditions.h"
 #include "model3d.h"
 
 namespace s21 {
 
+/**
+ * @brief Часть модели, опубликованная во время потоковой загрузки.
+ *
+ * Содержит вершины и рёбра граней, добавленные в модель с момента
+ * предыдущей публикации. Индексы рёбер абсолютные (относительно начала
+ * модели), вершины ещё не нормализованы.
+ */
+struct ModelBatch {
+  size_t firstVertex = 0;        ///< Индекс первой вершины пакета в модели
+  std::vector<Vertex> vertices;  ///< Новые вершины
+  std::vector<int> lineIndices;  ///< Пары индексов рёбер новых граней
+  size_t polygonCount = 0;       ///< Число новых граней
+  double progress = 1.0;  ///< Доля файла, разобранная к концу пакета
+};
+
 /**
  * @class ModelLoader
  * @brief Загружает 3D-модель из .obj-файла и нормализует её.
  *
  * Использует вспомогательный класс ObjParser для разбора содержимого
- * .obj-файла.
+ * .obj-файла. Загрузка может выполняться синхронно (loadModel()) или
+ * фоновой задачей общего ThreadPool (loadModelAsync()) с отчётом о
+ * прогрессе и отменой.
+ *
+ * Нормализованные модели сохраняются в двоичный кэш (MeshCache); при
+ * повторном открытии неизменённого файла модель читается из кэша без
+ * разбора текста.
+ *
+ * Большие файлы без актуального кэша загружаются в потоковом режиме: файл
+ * разбирается параллельно, как и остальные, а готовое начало файла публикуется
+ * сигналом batchReady() не чаще раза в kBatchInterval, чтобы модель
+ * появлялась на экране до завершения загрузки.
  */
 class ModelLoader : public QObject {
   Q_OBJECT
@@ -26,7 +62,19 @@ class ModelLoader : public QObject {
    * @brief Конструктор по умолчанию.
    * @param parent Родительский QObject.
    */
-  explicit ModelLoader(QObject *parent = nullptr) : QObject(parent) {}
+  explicit ModelLoader(QObject *parent = nullptr)
+      : QObject(parent),
+        cacheDir_(QStandardPaths::writableLocation(
+                      QStandardPaths::CacheLocation) +
+                  "/meshes") {}
+
+  /**
+   * @brief Деструктор. Отменяет фоновую загрузку и дожидается её завершения.
+   */
+  ~ModelLoader() override {
+    cancel();
+    for (const TaskHandle &task : tasks_) task.wait();
+  }
 
   /**
    * @brief Загружает модель из .obj-файла по указанному пути.
@@ -37,15 +85,252 @@ class ModelLoader : public QObject {
     //std::cout << "Start load" << std::endl;
     QString localPath = convertToLocalPath(filePath);  // Преобразуем путь
     if (!localPath.isEmpty()) {
-      model.clear();
-      ObjParser::loadObj(localPath.toStdString(), model);
-      model.normalizeModel();  // Вместо centerModel()
+      loadFile(localPath.toStdString(), cacheDir(), quantizedCache_, model,
+               nullptr);
     } else {
       qWarning() << "Failed to convert file path:" << filePath;
     }
   }
 
+  /**
+   * @brief Загружает модель фоновой задачей.
+   *
+   * Предыдущая незавершённая загрузка отменяется. Прогресс сообщается
+   * сигналом loadProgress(), части модели при потоковой загрузке — сигналом
+   * batchReady(), результат — сигналом modelReady() в потоке загрузчика.
+   * Разбор проверяет токен отмены и прекращается после cancel().
+   *
+   * @param filePath Путь к файлу (включая file://...).
+   */
+  Q_INVOKABLE void loadModelAsync(const QString &filePath) {
+    cancel();
+    QString localPath = convertToLocalPath(filePath);
+    if (localPath.isEmpty()) {
+      qWarning() << "Failed to convert file path:" << filePath;
+      emit loadFailed();
+      return;
+    }
+
+    CancellationToken token;
+    token_ = token;
+    quint64 generation = ++generation_;
+    std::string path = localPath.toStdString();
+    std::string cache = cacheDir();
+    bool quantized = quantizedCache_;
+    bool streaming = streamingThreshold_ >= 0 &&
+                     QFileInfo(localPath).size() >= streamingThreshold_;
+
+    auto load = [this, path, cache, quantized, token, generation,
+                 streaming]() {
+      ParseControl control;
+      control.cancelled = token.flag();
+      control.onProgress = [this, generation](size_t consumed, size_t total) {
+        double progress = total ? double(consumed) / double(total) : 1.0;
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, progress]() {
+              if (generation == generation_) emit loadProgress(progress);
+            },
+            Qt::QueuedConnection);
+      };
+
+      size_t publishedVertices = 0;
+      size_t publishedPolygons = 0;
+      auto lastPublish = std::chrono::steady_clock::time_point();
+      if (streaming) {
+        control.onBatch = [&, this, generation](const Model3D &partial,
+                                                size_t consumed,
+                                                size_t total) {
+          auto now = std::chrono::steady_clock::now();
+          if (now - lastPublish < kBatchInterval) return;
+          double progress = total ? double(consumed) / double(total) : 1.0;
+          auto batch = makeBatch(partial, publishedVertices, publishedPolygons,
+                                 progress);
+          if (!batch) return;
+          lastPublish = now;
+          QMetaObject::invokeMethod(
+              this,
+              [this, generation, batch]() {
+                if (generation == generation_) emit batchReady(batch);
+              },
+              Qt::QueuedConnection);
+        };
+      }
+
+      auto model = std::make_shared<Model3D>();
+      bool loaded = false;
+      try {
+        loaded = loadFile(path, cache, quantized, *model, &control);
+      } catch (const std::exception &e) {
+        qWarning() << "Failed to parse model:" << e.what();
+      }
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, generation, loaded, model]() {
+            if (generation != generation_) return;  // Загрузка устарела
+            if (loaded) {
+              emit modelReady(model);
+            } else {
+              emit loadFailed();
+            }
+          },
+          Qt::QueuedConnection);
+    };
+
+    // Описатели завершённых загрузок больше не нужны
+    tasks_.erase(std::remove_if(tasks_.begin(), tasks_.end(),
+                                [](const TaskHandle &task) {
+                                  return task.done();
+                                }),
+                 tasks_.end());
+    tasks_.push_back(ThreadPool::instance().submit(
+        load, TaskPriority::kBackground, token));
+  }
+
+  /**
+   * @brief Включает или выключает двоичный кэш моделей.
+   * @param dir Каталог кэша; пустая строка выключает кэш.
+   */
+  void setCacheDir(const QString &dir) { cacheDir_ = dir; }
+
+  /**
+   * @brief Задаёт минимальный размер файла для потоковой загрузки.
+   * @param bytes Размер в байтах; отрицательное значение выключает режим.
+   */
+  void setStreamingThreshold(qint64 bytes) { streamingThreshold_ = bytes; }
+
+  /**
+   * @brief Включает 16-битное хранение координат в новых файлах кэша
+   * (MeshCache::kQuantizedPositions). По умолчанию выключено.
+   */
+  void setQuantizedCache(bool quantized) { quantizedCache_ = quantized; }
+
+  static constexpr qint64 kDefaultStreamingThreshold =
+      qint64(32) << 20;  ///< Порог потоковой загрузки по умолчанию
+  static constexpr std::chrono::milliseconds kBatchInterval{
+      100};  ///< Минимальный интервал между публикациями частей модели
+
+  /**
+   * @brief Отменяет текущую фоновую загрузку.
+   */
+  Q_INVOKABLE void cancel() {
+    token_.cancel();
+    ++generation_;  // Результаты отменённой загрузки игнорируются
+  }
+
+ signals:
+  /**
+   * @brief Прогресс фоновой загрузки в диапазоне [0, 1].
+   */
+  void loadProgress(double progress);
+
+  /**
+   * @brief Очередная часть модели при потоковой загрузке.
+   *
+   * Пакеты приходят в порядке файла; первый пакет начинается с вершины 0.
+   * После всех пакетов приходит modelReady() с нормализованной моделью.
+   *
+   * @param batch Новые вершины и рёбра.
+   */
+  void batchReady(std::shared_ptr<const s21::ModelBatch> batch);
+
+  /**
+   * @brief Фоновая загрузка завершена, модель нормализована.
+   * @param model Загруженная модель.
+   */
+  void modelReady(std::shared_ptr<s21::Model3D> model);
+
+  /**
+   * @brief Фоновая загрузка завершилась ошибкой.
+   */
+  void loadFailed();
+
  private:
+  CancellationToken token_;  ///< Токен отмены текущей загрузки
+  quint64 generation_ = 0;   ///< Номер актуальной загрузки
+  std::vector<TaskHandle> tasks_;  ///< Поставленные задачи загрузки
+  QString cacheDir_;  ///< Каталог двоичного кэша моделей
+  qint64 streamingThreshold_ =
+      kDefaultStreamingThreshold;  ///< Порог потоковой загрузки
+  bool quantizedCache_ = false;    ///< 16-битные координаты в кэше
+
+  /**
+   * @brief Загружает и нормализует модель, используя кэш, если он актуален.
+   *
+   * Может выполняться в рабочем потоке: не обращается к членам класса.
+   * Если кэш не читается (в том числе с исключением), файл разбирается.
+   * Если в control задан onBatch, части модели публикуются в порядке файла
+   * по мере параллельного разбора (ObjParser::parseObjParallel()).
+   *
+   * @param quantized Записывать кэш с 16-битными координатами.
+   * @return false если файл не открыт или загрузка отменена.
+   */
+  static bool loadFile(const std::string &path, const std::string &cache,
+                       bool quantized, Model3D &model,
+                       const ParseControl *control) {
+    std::string cacheFile;
+    if (!cache.empty()) {
+      cacheFile = MeshCache::cachePath(cache, path);
+      try {
+        if (MeshCache::read(cacheFile, path, model)) {
+          if (control && control->onProgress) control->onProgress(1, 1);
+          return true;
+        }
+      } catch (const std::exception &e) {
+        // Испорченный кэш не мешает загрузке: файл разбирается заново
+        qWarning() << "Failed to read mesh cache:" << cacheFile.c_str()
+                   << e.what();
+      }
+    }
+
+    model.clear();
+    if (!ObjParser::loadObjParallel(path, model, 0, control)) return false;
+    model.normalizeModel();  // Вместо centerModel()
+
+    if (!cacheFile.empty() &&
+        !MeshCache::write(cacheFile, path, model, quantized)) {
+      qWarning() << "Failed to write mesh cache:" << cacheFile.c_str();
+    }
+    return true;
+  }
+
+  /**
+   * @brief Собирает пакет из вершин и граней, добавленных после
+   * publishedVertices и publishedPolygons, и сдвигает эти счётчики.
+   * @param progress Доля файла, разобранная к концу пакета.
+   * @return nullptr если новых элементов нет.
+   */
+  static std::shared_ptr<const ModelBatch> makeBatch(
+      const Model3D &model, size_t &publishedVertices,
+      size_t &publishedPolygons, double progress) {
+    if (publishedVertices == model.vertices.size() &&
+        publishedPolygons == model.polygons.size()) {
+      return nullptr;
+    }
+
+    auto batch = std::make_shared<ModelBatch>();
+    batch->firstVertex = publishedVertices;
+    batch->vertices.assign(model.vertices.begin() + publishedVertices,
+                           model.vertices.end());
+    for (size_t i = publishedPolygons; i < model.polygons.size(); ++i) {
+      // Вырожденные грани не дают рёбер и в превью пропускаются
+      if (model.polygons[i].size() >= 2) {
+        appendPolygonLines(model.polygons[i], batch->lineIndices);
+      }
+    }
+    batch->polygonCount = model.polygons.size() - publishedPolygons;
+    batch->progress = progress;
+    publishedVertices = model.vertices.size();
+    publishedPolygons = model.polygons.size();
+    return batch;
+  }
+
+  /**
+   * @brief Каталог кэша в виде std::string (пустой, если кэш выключен).
+   */
+  std::string cacheDir() const { return cacheDir_.toStdString(); }
+
   /**
    * @brief Преобразует путь file:// в локальный путь.
    * @param filePath Путь к файлу в формате URL.
@@ -63,4 +348,4 @@ class ModelLoader : public QObject {
 
 }  // namespace s21
 
-#endif
\ No newline at end of file
+#endif
@@ -4,6 +4,10 @@ using namespace s21;
 
 Saver::Saver(QObject* parent) : QObject(parent) {}
 
+Saver::~Saver() {
+  for (const TaskHandle& task : frameTasks_) task.wait();
+}
+
 void Saver::saveRenderImage(QObject* item, const QString& path) {
   QString folderPath = "screencasts";
   QDir().mkpath(folderPath);
@@ -14,27 +18,44 @@ void Saver::saveRenderImage(QObject* item, const QString& path) {
   auto grabResult = quickItem->grabToImage();
   if (!grabResult) return;
 
-  QObject::connect(grabResult.data(), &QQuickItemGrabResult::ready, this,
-                   [grabResult, path, folderPath]() {
-                     QImage image = grabResult->image();
-                     QImage opaque(image.size(), QImage::Format_RGB32);
-                     QPainter painter(&opaque);
-                     painter.drawImage(0, 0, image);
-                     painter.end();
-
-                     QString finalPath = folderPath + "/" + path;
-                     if (!opaque.save(finalPath)) {
-                       qWarning() << "Failed to save image to:" << finalPath;
-                     } else {
-                       qDebug() << "Saved image to:" << finalPath;
-                     }
-                   });
+  QObject::connect(
+      grabResult.data(), &QQuickItemGrabResult::ready, this,
+      [grabResult, path, folderPath]() {
+        // Кодирование PNG выполняется фоновой задачей, а не в потоке GUI
+        QImage image = grabResult->image();
+        ThreadPool::instance().submit(
+            [image, path, folderPath]() {
+              QImage opaque(image.size(), QImage::Format_RGB32);
+              QPainter painter(&opaque);
+              painter.drawImage(0, 0, image);
+              painter.end();
+
+              QString finalPath = folderPath + "/" + path;
+              if (!opaque.save(finalPath)) {
+                qWarning() << "Failed to save image to:" << finalPath;
+              } else {
+                qDebug() << "Saved image to:" << finalPath;
+              }
+            },
+            TaskPriority::kBackground);
+      });
 }
 
 void Saver::startGifRecording(QObject* item) {
+  if (isRecording()) {
+    qWarning() << "GIF recording is already in progress";
+    return;
+  }
   gifItem_ = item;
   frameCounter_ = 0;
-  QDir().mkpath("screencasts");
+  capturing_ = true;
+  frameTasks_.clear();
+  // Кадры каждой записи лежат отдельно: сборка прежней записи не смешает
+  // их со своими и не удалит
+  recordingDir_ =
+      QString("screencasts/frames_%1")
+          .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_zzz"));
+  QDir().mkpath(recordingDir_);
 
   if (!gifTimer_) {
     gifTimer_ = new QTimer(this);
@@ -47,6 +68,7 @@ void Saver::startGifRecording(QObject* item) {
 void Saver::recordGifFrame() {
   if (frameCounter_ >= totalFrames_) {
     gifTimer_->stop();
+    capturing_ = false;
     finishGifRecording();
     return;
   }
@@ -57,48 +79,92 @@ void Saver::recordGifFrame() {
   auto grabResult = quickItem->grabToImage();
   if (!grabResult) return;
 
-  int currentFrame = frameCounter_;
+  QString path = QString("%1/frame_%2.png")
+                     .arg(recordingDir_)
+                     .arg(frameCounter_, 3, 10, QChar('0'));
+  ++pendingFrames_;
   connect(grabResult.data(), &QQuickItemGrabResult::ready, this,
-          [grabResult, currentFrame]() {
+          [this, grabResult, path]() {
             QImage source = grabResult->image();
-            QImage scaled = source.scaled(640, 480, Qt::KeepAspectRatio,
-                                          Qt::SmoothTransformation);
-
-            QImage final(640, 480, QImage::Format_RGB32);
-            final.fill(Qt::white);
-
-            QPainter painter(&final);
-            int x = (640 - scaled.width()) / 2;
-            int y = (480 - scaled.height()) / 2;
-            painter.drawImage(x, y, scaled);
-            painter.end();
-
-            QString path = QString("screencasts/frame_%1.png")
-                               .arg(currentFrame, 3, 10, QChar('0'));
-            final.save(path);
+            frameTasks_.push_back(ThreadPool::instance().submit(
+                [this, source, path]() {
+                  QImage scaled =
+                      source.scaled(640, 480, Qt::KeepAspectRatio,
+                                    Qt::SmoothTransformation);
+
+                  QImage final(640, 480, QImage::Format_RGB32);
+                  final.fill(Qt::white);
+
+                  QPainter painter(&final);
+                  int x = (640 - scaled.width()) / 2;
+                  int y = (480 - scaled.height()) / 2;
+                  painter.drawImage(x, y, scaled);
+                  painter.end();
+
+                  final.save(path);
+                  QMetaObject::invokeMethod(
+                      this,
+                      [this]() {
+                        --pendingFrames_;
+                        finishGifRecording();
+                      },
+                      Qt::QueuedConnection);
+                },
+                TaskPriority::kBackground));
           });
 
   frameCounter_++;
 }
 
 void Saver::finishGifRecording() {
+  // Сборка начинается один раз, когда захват закончен и все кадры записаны
+  if (capturing_ || pendingFrames_ > 0 || assembler_ ||
+      recordingDir_.isEmpty()) {
+    return;
+  }
+
   QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
   QString outputPath = QString("screencasts/screencast_%1.gif").arg(timestamp);
 
-  QString command =
-      QString("convert -delay 10 -loop 0 screencasts/frame_*.png %1")
-          .arg(outputPath);
-  int result = system(command.toUtf8().constData());
+  QDir dir(recordingDir_);
+  QStringList frameFiles =
+      dir.entryList(QStringList() << "frame_*.png", QDir::Files, QDir::Name);
+  if (frameFiles.isEmpty()) {
+    finishAssembly(false, outputPath);
+    return;
+  }
+  QStringList arguments = {"-delay", "10", "-loop", "0"};
+  for (const QString& file : frameFiles) arguments << dir.filePath(file);
+  arguments << outputPath;
+
+  // convert работает отдельным процессом; о завершении сообщают сигналы
+  assembler_ = new QProcess(this);
+  connect(assembler_, &QProcess::finished, this,
+          [this, outputPath](int exitCode, QProcess::ExitStatus status) {
+            finishAssembly(status == QProcess::NormalExit && exitCode == 0,
+                           outputPath);
+          });
+  connect(assembler_, &QProcess::errorOccurred, this,
+          [this, outputPath](QProcess::ProcessError error) {
+            // Если процесс не запустился, finished не придёт
+            if (error == QProcess::FailedToStart) {
+              finishAssembly(false, outputPath);
+            }
+          });
+  assembler_->start("convert", arguments);
+}
 
-  if (result == 0) {
+void Saver::finishAssembly(bool saved, const QString& outputPath) {
+  if (saved) {
     qDebug() << "GIF saved to:" << outputPath;
   } else {
     qWarning() << "Failed to create GIF. Is ImageMagick installed?";
   }
 
-  QDir dir("screencasts");
-  QStringList frames = dir.entryList(QStringList() << "frame_*.png");
-  for (const QString& file : frames) {
-    dir.remove(file);
+  QDir(recordingDir_).removeRecursively();
+  recordingDir_.clear();
+  if (assembler_) {
+    assembler_->deleteLater();
+    assembler_ = nullptr;
   }
 }
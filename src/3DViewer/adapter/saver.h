@@ -23,9 +23,13 @@
 #include <QImage>
 #include <QObject>
 #include <QPainter>
+#include <QProcess>
 #include <QQuickItem>
 #include <QQuickItemGrabResult>
 #include <QTimer>
+#include <vector>
+
+#include "../core/threadpool.h"
 
 namespace s21 {
 
@@ -53,12 +57,19 @@ class Saver : public QObject {
    */
   explicit Saver(QObject* parent = nullptr);
 
+  /**
+   * @brief Деструктор: дожидается фоновых задач сохранения кадров, которые
+   * сообщают о готовности этому объекту.
+   */
+  ~Saver() override;
+
   /**
    * @brief Сохраняет текущее изображение из элемента QML в виде PNG-файла.
    *
    * Создает директорию `screencasts`, если она отсутствует. Делает захват
    * изображения с указанного QQuickItem, перекрашивает фон в белый, и сохраняет
-   * результат в указанный путь.
+   * результат в указанный путь. Обработка и запись файла выполняются
+   * фоновой задачей ThreadPool.
    *
    * @param item Указатель на QML-объект (обычно `QQuickItem*`), из которого
    * будет захвачено изображение.
@@ -71,8 +82,10 @@ class Saver : public QObject {
    * @brief Запускает запись GIF-анимации с указанного элемента.
    *
    * Сохраняет 50 кадров (по 10 кадров в секунду, в течение 5 секунд) из объекта
-   * QML (обычно `QQuickItem`). Кадры сохраняются в директорию `screencasts`,
-   * после чего вызывается метод finishGifRecording().
+   * QML (обычно `QQuickItem`). Кадры каждой записи сохраняются в отдельную
+   * директорию `screencasts/frames_<время>`, после чего вызывается метод
+   * finishGifRecording(). Пока предыдущая запись не собрана в GIF, новая не
+   * начинается.
    *
    * @param item Указатель на QML-объект, с которого будет происходить захват
    * кадров.
@@ -85,17 +98,21 @@ class Saver : public QObject {
    *
    * Выполняет захват изображения с `gifItem_`, масштабирует его до 640x480,
    * центрирует на белом фоне, и сохраняет как PNG-файл `frame_XXX.png` в
-   * директории `screencasts`. При достижении общего количества кадров
-   * (`totalFrames_`) останавливает таймер и завершает запись GIF.
+   * директории записи. При достижении общего количества кадров
+   * (`totalFrames_`) останавливает таймер и завершает запись GIF. Обработка
+   * кадра выполняется фоновой задачей ThreadPool.
    */
   void recordGifFrame();
 
   /**
    * @brief Завершает запись GIF-анимации и сохраняет её с помощью ImageMagick.
    *
-   * Объединяет PNG-кадры, сохранённые ранее в директории `screencasts`, в один
-   * GIF-файл с помощью команды `convert`. Также удаляет временные PNG-файлы
-   * после создания GIF.
+   * Объединяет PNG-кадры, сохранённые в директории записи, в один GIF-файл
+   * с помощью команды `convert`. Также удаляет директорию кадров после
+   * создания GIF. Вызывается после захвата последнего кадра и после
+   * сохранения каждого кадра; сборка начинается, когда сохранены все кадры.
+   * `convert` запускается через QProcess асинхронно и не занимает ни поток
+   * GUI, ни поток ThreadPool.
    *
    * @warning Требуется установленный ImageMagick (`convert` должен быть
    * доступен в PATH).
@@ -107,6 +124,23 @@ class Saver : public QObject {
   QObject* gifItem_ = nullptr;
   int frameCounter_ = 0;
   const int totalFrames_ = 50;
+  bool capturing_ = false;   ///< Идёт захват кадров по таймеру
+  int pendingFrames_ = 0;    ///< Кадры, захват которых ещё не сохранён
+  QString recordingDir_;     ///< Директория кадров текущей записи
+  QProcess* assembler_ = nullptr;       ///< Процесс `convert` сборки GIF
+  std::vector<TaskHandle> frameTasks_;  ///< Задачи сохранения кадров GIF
+
+  /**
+   * @brief Идёт ли запись: захват, сохранение кадров или сборка GIF.
+   */
+  bool isRecording() const {
+    return capturing_ || pendingFrames_ > 0 || assembler_ != nullptr;
+  }
+
+  /**
+   * @brief Сообщает результат сборки GIF и удаляет директорию кадров.
+   */
+  void finishAssembly(bool saved, const QString& outputPath);
 };  // class Saver
 
 }  // namespace s21
@@ -0,0 +1,235 @@
+/**
+ * @file bench.cpp
+ * @brief 3DViewerBench — замер конвейера загрузки модели без окна QML.
+ *
+ * Для каждого файла выполняются этапы, через которые проходит модель при
+ * открытии в просмотрщике: разбор OBJ, нормализация, поворот и сдвиг,
+ * упаковка буферов вершин и индексов LinesGeometry. Результат печатается в
+ * stdout в формате JSON, чтобы сравнивать сборки между выпусками.
+ *
+ * Использование:
+ * @code
+ * 3DViewerBench [--repeat N] [--loader stream|mapped|parallel] [file.obj...]
+ * @endcode
+ * Без файлов замеряются все *.obj из data-samples. Время этапа — лучшее из
+ * N повторов; MB/s для загрузки считается по размеру файла, для остальных
+ * этапов — по размеру массива вершин (для упаковки — по размеру буферов).
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "adapter/linesgeometry.h"
+#include "io/objloader.h"
+
+using namespace s21;
+
+namespace {
+
+/**
+ * @brief Результат одного этапа: лучшее время из повторов и объём данных.
+ */
+struct Stage {
+  const char *name;    ///< Имя этапа в JSON
+  double seconds = 0;  ///< Наименьшее время из повторов
+  double bytes = 0;    ///< Объём обработанных данных
+};
+
+/**
+ * @brief Пиковый объём резидентной памяти процесса в килобайтах.
+ */
+long peakRssKb() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;  // В Linux — килобайты
+}
+
+/**
+ * @brief Время выполнения action в секундах.
+ */
+template <typename Action>
+double measure(Action &&action) {
+  auto start = std::chrono::steady_clock::now();
+  action();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/**
+ * @brief Строка в кавычках JSON.
+ */
+std::string jsonString(const std::string &text) {
+  std::string result = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escape[8];
+      std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+      result += escape;
+    } else {
+      result += c;
+    }
+  }
+  return result + "\"";
+}
+
+/**
+ * @brief Загружает модель выбранным загрузчиком.
+ */
+bool load(const std::string &loader, const std::string &path, Model3D &model) {
+  if (loader == "mapped") return ObjParser::loadObjMapped(path, model);
+  if (loader == "parallel") return ObjParser::loadObjParallel(path, model);
+  return ObjParser::loadObj(path, model);
+}
+
+/**
+ * @brief Прогоняет этапы конвейера для одного файла repeat раз.
+ * @return false если файл не удалось загрузить.
+ */
+bool benchFile(const std::string &path, const std::string &loader, int repeat,
+               std::vector<Stage> &stages, Model3D &model) {
+  stages = {{"load"}, {"normalize"}, {"rotate"}, {"shift"}, {"pack"}};
+  for (Stage &stage : stages) stage.seconds = 1e300;
+  double fileBytes = static_cast<double>(std::filesystem::file_size(path));
+
+  for (int run = 0; run < repeat; ++run) {
+    model = Model3D();
+    bool loaded = true;
+    double seconds = measure([&] { loaded = load(loader, path, model); });
+    if (!loaded) return false;
+
+    double vertexBytes =
+        static_cast<double>(model.vertices.size() * sizeof(Vertex));
+    QByteArray vertexData;
+    QByteArray indexData;
+    double times[] = {
+        seconds, measure([&] { model.normalizeModel(); }),
+        measure([&] { model.rotateModel(30.0f, 45.0f, 60.0f); }),
+        measure([&] { model.shiftModel(0.25f, -0.5f, 0.75f); }),
+        measure([&] {
+          vertexData = LinesGeometry::packVertices(model.vertices);
+          indexData = LinesGeometry::packLineIndices(model.polygons,
+                                                     model.vertices.size());
+        })};
+    double bytes[] = {fileBytes, vertexBytes, vertexBytes, vertexBytes,
+                      static_cast<double>(vertexData.size() +
+                                          indexData.size())};
+    for (size_t i = 0; i < stages.size(); ++i) {
+      stages[i].seconds = std::min(stages[i].seconds, times[i]);
+      stages[i].bytes = bytes[i];
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Печатает результат одного файла объектом JSON.
+ */
+void printFile(const std::string &path, const Model3D &model,
+               const std::vector<Stage> &stages) {
+  double faces = static_cast<double>(model.polygons.size());
+  std::printf("    {\n      \"file\": %s,\n", jsonString(path).c_str());
+  auto fileBytes = std::filesystem::file_size(path);
+  std::printf("      \"bytes\": %llu,\n",
+              static_cast<unsigned long long>(fileBytes));
+  std::printf("      \"vertices\": %zu,\n", model.vertices.size());
+  std::printf("      \"faces\": %zu,\n", model.polygons.size());
+  std::printf("      \"stages\": {\n");
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const Stage &stage = stages[i];
+    double seconds = std::max(stage.seconds, 1e-9);
+    std::printf(
+        "        %s: {\"seconds\": %.6f, \"mb_per_s\": %.2f, "
+        "\"faces_per_s\": %.0f}%s\n",
+        jsonString(stage.name).c_str(), stage.seconds,
+        stage.bytes / (1024.0 * 1024.0) / seconds, faces / seconds,
+        i + 1 < stages.size() ? "," : "");
+  }
+  std::printf("      },\n      \"peak_rss_kb\": %ld\n    }", peakRssKb());
+}
+
+/**
+ * @brief Все *.obj каталога в порядке имён.
+ */
+std::vector<std::string> objFiles(const std::string &directory) {
+  std::vector<std::string> files;
+  std::error_code error;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(directory, error)) {
+    if (entry.path().extension() == ".obj") files.push_back(entry.path());
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  int repeat = 3;
+  std::string loader = "stream";
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--loader" && i + 1 < argc) {
+      loader = argv[++i];
+    } else if (arg == "--help" || arg == "-h") {
+      std::cout << "Usage: " << argv[0]
+                << " [--repeat N] [--loader stream|mapped|parallel]"
+                   " [file.obj...]\n";
+      return 0;
+    } else {
+      files.push_back(arg);
+    }
+  }
+  if (loader != "stream" && loader != "mapped" && loader != "parallel") {
+    std::cerr << "Error: Unknown loader " << loader << "\n";
+    return 2;
+  }
+  if (files.empty()) files = objFiles(DATA_SAMPLES_DIR);
+  if (files.empty()) {
+    std::cerr << "Error: No .obj files to benchmark\n";
+    return 2;
+  }
+
+  std::printf("{\n  \"loader\": %s,\n  \"repeat\": %d,\n  \"threads\": %u,\n",
+              jsonString(loader).c_str(), repeat,
+              ThreadPool::instance().concurrency());
+  std::printf("  \"files\": [\n");
+  int failed = 0;
+  bool first = true;
+  for (const std::string &path : files) {
+    std::vector<Stage> stages;
+    Model3D model;
+    bool ok = false;
+    try {
+      ok = std::filesystem::is_regular_file(path) &&
+           benchFile(path, loader, repeat, stages, model);
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << path << ": " << e.what() << "\n";
+    }
+    if (!ok) {
+      std::cerr << "Error: Cannot benchmark " << path << "\n";
+      ++failed;
+      continue;
+    }
+    if (!first) std::printf(",\n");
+    first = false;
+    printFile(path, model, stages);
+  }
+  std::printf("\n  ],\n  \"failed\": %d,\n  \"peak_rss_kb\": %ld\n}\n", failed,
+              peakRssKb());
+  return failed == 0 ? 0 : 1;
+}
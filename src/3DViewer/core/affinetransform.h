@@ -0,0 +1,225 @@
+/**
+ * @file affinetransform.h
+ * @brief Класс AffineTransform — аффинное преобразование трёхмерного
+ * пространства (поворот, масштаб, перенос).
+ */
+
+#ifndef AFFINE_TRANSFORM_H
+#define AFFINE_TRANSFORM_H
+
+#include <cmath>
+
+namespace s21 {
+
+/**
+ * @class AffineTransform
+ * @brief Аффинное преобразование в виде матрицы 3x4 (линейная часть и
+ * столбец переноса).
+ *
+ * Последовательность преобразований складывается в одну матрицу, поэтому
+ * вершины обрабатываются за один проход вместо отдельного прохода на
+ * каждый шаг.
+ */
+class AffineTransform {
+ public:
+  float m[3][4];  ///< Строки матрицы; m[i][3] — перенос
+
+  /**
+   * @brief Конструктор тождественного преобразования.
+   */
+  AffineTransform() : m{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}} {}
+
+  /**
+   * @brief Перенос на вектор (dx, dy, dz).
+   */
+  static AffineTransform translation(float dx, float dy, float dz) {
+    AffineTransform t;
+    t.m[0][3] = dx;
+    t.m[1][3] = dy;
+    t.m[2][3] = dz;
+    return t;
+  }
+
+  /**
+   * @brief Равномерное масштабирование относительно начала координат.
+   */
+  static AffineTransform scaling(float factor) {
+    AffineTransform t;
+    t.m[0][0] = t.m[1][1] = t.m[2][2] = factor;
+    return t;
+  }
+
+  /**
+   * @brief Поворот вокруг осей X, затем Y, затем Z (углы в градусах), как в
+   * Model3D::rotateModel().
+   */
+  static AffineTransform rotation(float angleX, float angleY, float angleZ) {
+    float radX = angleX * M_PI / 180.0f;
+    float radY = angleY * M_PI / 180.0f;
+    float radZ = angleZ * M_PI / 180.0f;
+    float cosX = std::cos(radX), sinX = std::sin(radX);
+    float cosY = std::cos(radY), sinY = std::sin(radY);
+    float cosZ = std::cos(radZ), sinZ = std::sin(radZ);
+
+    AffineTransform rx, ry, rz;
+    rx.m[1][1] = cosX, rx.m[1][2] = -sinX;
+    rx.m[2][1] = sinX, rx.m[2][2] = cosX;
+    ry.m[0][0] = cosY, ry.m[0][2] = sinY;
+    ry.m[2][0] = -sinY, ry.m[2][2] = cosY;
+    rz.m[0][0] = cosZ, rz.m[0][1] = -sinZ;
+    rz.m[1][0] = sinZ, rz.m[1][1] = cosZ;
+    return rz * ry * rx;
+  }
+
+  /**
+   * @brief То же преобразование, но с неподвижной точкой (cx, cy, cz)
+   * вместо начала координат: T(c) * this * T(-c).
+   */
+  AffineTransform about(float cx, float cy, float cz) const {
+    return translation(cx, cy, cz) * *this * translation(-cx, -cy, -cz);
+  }
+
+  /**
+   * @brief Композиция: сначала other, затем this.
+   */
+  AffineTransform operator*(const AffineTransform& other) const {
+    AffineTransform result;
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        float value = j == 3 ? m[i][3] : 0.0f;
+        for (int k = 0; k < 3; ++k) value += m[i][k] * other.m[k][j];
+        result.m[i][j] = value;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Обратное преобразование.
+   *
+   * Линейная часть обращается через присоединённую матрицу; для
+   * вырожденной матрицы (нулевой масштаб) результат не определён.
+   */
+  AffineTransform inverse() const {
+    AffineTransform result;
+    float det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    float invDet = 1.0f / det;
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        // Алгебраическое дополнение элемента (j, i)
+        int r0 = (j + 1) % 3, r1 = (j + 2) % 3;
+        int c0 = (i + 1) % 3, c1 = (i + 2) % 3;
+        result.m[i][j] =
+            (m[r0][c0] * m[r1][c1] - m[r0][c1] * m[r1][c0]) * invDet;
+      }
+    }
+    for (int i = 0; i < 3; ++i) {
+      result.m[i][3] = -(result.m[i][0] * m[0][3] + result.m[i][1] * m[1][3] +
+                         result.m[i][2] * m[2][3]);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Применяет преобразование к точке.
+   */
+  void apply(float& x, float& y, float& z) const {
+    float nx = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3];
+    float ny = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3];
+    float nz = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3];
+    x = nx;
+    y = ny;
+    z = nz;
+  }
+};  // class AffineTransform
+
+/**
+ * @class PreciseRotation
+ * @brief Матрица поворота 3x3 в двойной точности.
+ *
+ * Нужна там, где поворот многократно применяется к одним и тем же вершинам
+ * (Model3D::rotateModel()): обратный поворот — транспонированная матрица,
+ * и шаг между двумя поворотами не накапливает ошибку округления float.
+ */
+class PreciseRotation {
+ public:
+  double m[3][3];  ///< Строки матрицы
+
+  /**
+   * @brief Конструктор тождественного поворота.
+   */
+  PreciseRotation() : m{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}} {}
+
+  /**
+   * @brief Поворот вокруг осей X, затем Y, затем Z (углы в градусах), как
+   * AffineTransform::rotation().
+   */
+  static PreciseRotation fromAngles(float angleX, float angleY,
+                                    float angleZ) {
+    double radX = angleX * M_PI / 180.0;
+    double radY = angleY * M_PI / 180.0;
+    double radZ = angleZ * M_PI / 180.0;
+    double cosX = std::cos(radX), sinX = std::sin(radX);
+    double cosY = std::cos(radY), sinY = std::sin(radY);
+    double cosZ = std::cos(radZ), sinZ = std::sin(radZ);
+
+    PreciseRotation rx, ry, rz;
+    rx.m[1][1] = cosX, rx.m[1][2] = -sinX;
+    rx.m[2][1] = sinX, rx.m[2][2] = cosX;
+    ry.m[0][0] = cosY, ry.m[0][2] = sinY;
+    ry.m[2][0] = -sinY, ry.m[2][2] = cosY;
+    rz.m[0][0] = cosZ, rz.m[0][1] = -sinZ;
+    rz.m[1][0] = sinZ, rz.m[1][1] = cosZ;
+    return rz * ry * rx;
+  }
+
+  /**
+   * @brief Композиция: сначала other, затем this.
+   */
+  PreciseRotation operator*(const PreciseRotation& other) const {
+    PreciseRotation result;
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        double value = 0;
+        for (int k = 0; k < 3; ++k) value += m[i][k] * other.m[k][j];
+        result.m[i][j] = value;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Обратный поворот (транспонированная матрица).
+   */
+  PreciseRotation inverse() const {
+    PreciseRotation result;
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) result.m[i][j] = m[j][i];
+    }
+    return result;
+  }
+
+  /**
+   * @brief Поворот вокруг точки (cx, cy, cz) в виде AffineTransform;
+   * перенос вычисляется в двойной точности.
+   */
+  AffineTransform about(float cx, float cy, float cz) const {
+    AffineTransform result;
+    double center[3] = {cx, cy, cz};
+    for (int i = 0; i < 3; ++i) {
+      double shift = center[i];
+      for (int k = 0; k < 3; ++k) {
+        result.m[i][k] = static_cast<float>(m[i][k]);
+        shift -= m[i][k] * center[k];
+      }
+      result.m[i][3] = static_cast<float>(shift);
+    }
+    return result;
+  }
+};  // class PreciseRotation
+
+}  // namespace s21
+
+#endif  // AFFINE_TRANSFORM_H
@@ -0,0 +1,606 @@
+/**
+ * @file bvh.h
+ * @brief Класс Bvh — иерархия ограничивающих боксов над отрезками модели
+ * для поиска ближайшего к лучу ребра или вершины.
+ */
+
+#ifndef BVH_H
+#define BVH_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "affinetransform.h"
+#include "model3d.h"
+#include "threadpool.h"
+#include "vertexkernels.h"
+
+namespace s21 {
+
+/**
+ * @brief Луч origin + t * direction, t >= 0.
+ */
+struct Ray {
+  float origin[3] = {0, 0, 0};
+  float direction[3] = {0, 0, -1};
+
+  /**
+   * @brief Образ луча при преобразовании t (например, из координат сцены в
+   * координаты модели).
+   */
+  Ray transformed(const AffineTransform& t) const {
+    Ray result;
+    float x = origin[0], y = origin[1], z = origin[2];
+    t.apply(x, y, z);
+    result.origin[0] = x, result.origin[1] = y, result.origin[2] = z;
+    for (int i = 0; i < 3; ++i) {
+      result.direction[i] = t.m[i][0] * direction[0] +
+                            t.m[i][1] * direction[1] +
+                            t.m[i][2] * direction[2];
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief Результат поиска ближайшего к лучу отрезка.
+ */
+struct BvhHit {
+  bool found = false;      ///< Найден отрезок ближе радиуса поиска
+  size_t segment = 0;      ///< Номер отрезка в порядке build()
+  float distance = 0.0f;   ///< Расстояние от луча до отрезка
+  float depth = 0.0f;      ///< Параметр t ближайшей точки луча
+  float along = 0.0f;      ///< Положение ближайшей точки на отрезке [0, 1]
+};
+
+/**
+ * @class Bvh
+ * @brief Линейная BVH (LBVH) над отрезками между вершинами модели.
+ *
+ * Отрезки (рёбра или вырожденные отрезки-вершины) сортируются по кодам
+ * Мортона центров и группируются в листья по kLeafSize; внутренние узлы
+ * строятся независимо друг от друга по общим префиксам кодов (Karras,
+ * 2012), поэтому все шаги построения выполняются в ThreadPool. Боксы
+ * узлов пересчитываются снизу вверх refit() за O(n) без перестройки
+ * дерева, если вершины сдвинулись, а рёбра остались прежними.
+ *
+ * Поворот и сдвиг Model3D::transform дерево не меняют: луч переводится в
+ * координаты модели (Ray::transformed()).
+ */
+class Bvh {
+ public:
+  static constexpr size_t kLeafSize = 4;  ///< Отрезков в листе
+  static constexpr size_t kParallelGrain =
+      1 << 16;  ///< Порог распараллеливания построения
+
+  /**
+   * @brief Строит дерево над отрезками lineIndices (пары индексов вершин,
+   * как у convertToUniqueLines()).
+   *
+   * @param cancel Токен отмены; проверяется между параллельными проходами
+   * построения.
+   * @return false если построение отменено; дерево тогда пусто.
+   */
+  bool build(const std::vector<Vertex>& vertices,
+             const std::vector<int>& lineIndices,
+             const CancellationToken* cancel = nullptr) {
+    return build(vertices, pairs(lineIndices), cancel);
+  }
+
+  /**
+   * @brief Строит дерево над всеми вершинами (отрезки (i, i)).
+   * @return false если построение отменено; дерево тогда пусто.
+   */
+  bool buildPoints(const std::vector<Vertex>& vertices,
+                   const CancellationToken* cancel = nullptr) {
+    std::vector<std::array<int, 2>> segments(vertices.size());
+    ThreadPool::instance().parallelFor(
+        segments.size(), kParallelGrain, [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            segments[i] = {static_cast<int>(i), static_cast<int>(i)};
+          }
+        });
+    return build(vertices, std::move(segments), cancel);
+  }
+
+  /**
+   * @brief Пересчитывает боксы по новым координатам тех же вершин.
+   */
+  void refit(const std::vector<Vertex>& vertices) {
+    size_t leaves = leafBoxes_.size();
+    std::vector<std::atomic<uint32_t>> visits(nodes_.size());
+    ThreadPool::instance().parallelFor(
+        leaves, kParallelGrain / kLeafSize, [&](size_t begin, size_t end) {
+          for (size_t leaf = begin; leaf < end; ++leaf) {
+            leafBoxes_[leaf] = leafBox(vertices, leaf);
+            // Узел считает второй из пришедших к нему потоков: оба
+            // дочерних бокса к этому моменту готовы
+            uint32_t node = leafParent_[leaf];
+            while (node != kNone) {
+              if (visits[node].fetch_add(1, std::memory_order_acq_rel) == 0) {
+                break;
+              }
+              BoundingBox box = childBox(nodes_[node].child[0]);
+              box.merge(childBox(nodes_[node].child[1]));
+              nodes_[node].box = box;
+              node = nodeParent_[node];
+            }
+          }
+        });
+  }
+
+  /**
+   * @brief Ближайший к лучу отрезок на расстоянии не больше radius.
+   *
+   * @param vertices Вершины, по которым строилось дерево.
+   * @param ray Луч в координатах вершин.
+   */
+  BvhHit closest(const std::vector<Vertex>& vertices, const Ray& ray,
+                 float radius) const {
+    BvhHit best;
+    if (leafBoxes_.empty()) return best;
+
+    float inverse[3];
+    for (int axis = 0; axis < 3; ++axis) {
+      inverse[axis] = 1.0f / ray.direction[axis];  // ±inf для нуля
+    }
+    float limit = radius;
+    uint32_t stack[kMaxDepth];
+    size_t top = 0;
+    stack[top++] = nodes_.empty() ? kLeafFlag : 0;
+    while (top > 0) {
+      uint32_t child = stack[--top];
+      if (child & kLeafFlag) {
+        size_t leaf = child & ~kLeafFlag;
+        if (!near(leafBoxes_[leaf], ray, inverse, limit)) continue;
+        size_t end = std::min(segments_.size(), (leaf + 1) * kLeafSize);
+        for (size_t i = leaf * kLeafSize; i < end; ++i) {
+          BvhHit hit = distance(vertices, segments_[i], ray);
+          if (hit.distance <= limit &&
+              (!best.found || hit.distance < best.distance)) {
+            best = hit;
+            best.found = true;
+            best.segment = ids_[i];
+            limit = hit.distance;
+          }
+        }
+        continue;
+      }
+      const Node& node = nodes_[child];
+      float entry[2];
+      bool hits[2];
+      for (int k = 0; k < 2; ++k) {
+        hits[k] = near(childBox(node.child[k]), ray, inverse, limit, &entry[k]);
+      }
+      // Ближний потомок обходится первым, чтобы быстрее сузить limit
+      int first = hits[1] && (!hits[0] || entry[1] < entry[0]) ? 1 : 0;
+      if (hits[1 - first]) stack[top++] = node.child[1 - first];
+      if (hits[first]) stack[top++] = node.child[first];
+    }
+    return best;
+  }
+
+  /**
+   * @brief Номера отрезков lineIndices, упорядоченные по кодам Мортона их
+   * центров: соседние в этом порядке отрезки близки в пространстве.
+   */
+  static std::vector<uint32_t> mortonOrder(
+      const std::vector<Vertex>& vertices,
+      const std::vector<int>& lineIndices) {
+    std::vector<uint64_t> keys = sortedKeys(vertices, pairs(lineIndices));
+    std::vector<uint32_t> order(keys.size());
+    ThreadPool::instance().parallelFor(
+        keys.size(), kParallelGrain, [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            order[i] = static_cast<uint32_t>(keys[i]);
+          }
+        });
+    return order;
+  }
+
+  /**
+   * @brief Ближайший отрезок перебором всех отрезков (эталон для проверки
+   * и сравнения скорости).
+   */
+  static BvhHit scan(const std::vector<Vertex>& vertices,
+                     const std::vector<int>& lineIndices, const Ray& ray,
+                     float radius) {
+    BvhHit best;
+    for (size_t i = 0; i + 1 < lineIndices.size(); i += 2) {
+      BvhHit hit = distance(vertices, {lineIndices[i], lineIndices[i + 1]},
+                            ray);
+      if (hit.distance <= radius &&
+          (!best.found || hit.distance < best.distance)) {
+        best = hit;
+        best.found = true;
+        best.segment = i / 2;
+      }
+    }
+    return best;
+  }
+
+  /**
+   * @brief Расстояние от луча до отрезка (a, b) и ближайшие точки.
+   */
+  static BvhHit distance(const std::vector<Vertex>& vertices,
+                         const std::array<int, 2>& segment, const Ray& ray) {
+    const Vertex& a = vertices[segment[0]];
+    const Vertex& b = vertices[segment[1]];
+    const double d1[3] = {ray.direction[0], ray.direction[1],
+                          ray.direction[2]};
+    const double d2[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+    const double r[3] = {ray.origin[0] - a.x, ray.origin[1] - a.y,
+                         ray.origin[2] - a.z};
+    auto dot = [](const double* u, const double* v) {
+      return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+    };
+    double dd = dot(d1, d1), ee = dot(d2, d2);
+    double f = dot(d2, r), c = dot(d1, r), bb = dot(d1, d2);
+    double t = 0.0, s = 0.0;
+    if (dd > 0.0) {
+      if (ee <= 0.0) {
+        t = std::max(0.0, -c / dd);  // Отрезок вырожден в точку
+      } else {
+        double denominator = dd * ee - bb * bb;
+        if (denominator > 1e-12 * dd * ee) {
+          t = std::max(0.0, (bb * f - c * ee) / denominator);
+        }
+        s = (bb * t + f) / ee;
+        if (s < 0.0) {
+          s = 0.0, t = std::max(0.0, -c / dd);
+        } else if (s > 1.0) {
+          s = 1.0, t = std::max(0.0, (bb - c) / dd);
+        }
+      }
+    }
+    BvhHit hit;
+    double gap[3];
+    for (int i = 0; i < 3; ++i) gap[i] = r[i] + t * d1[i] - s * d2[i];
+    hit.distance = static_cast<float>(std::sqrt(dot(gap, gap)));
+    hit.depth = static_cast<float>(t);
+    hit.along = static_cast<float>(s);
+    return hit;
+  }
+
+  /**
+   * @brief Число отрезков.
+   */
+  size_t size() const { return segments_.size(); }
+
+  /**
+   * @brief Дерево не содержит отрезков.
+   */
+  bool empty() const { return segments_.empty(); }
+
+  /**
+   * @brief Вершины отрезка с номером index в порядке build().
+   */
+  std::array<int, 2> segment(size_t index) const {
+    return segments_[positions_[index]];
+  }
+
+  /**
+   * @brief Бокс всех отрезков.
+   */
+  BoundingBox bounds() const {
+    if (leafBoxes_.empty()) return BoundingBox();
+    return nodes_.empty() ? leafBoxes_[0] : nodes_[0].box;
+  }
+
+ private:
+  static constexpr uint32_t kLeafFlag = 0x80000000u;  ///< Потомок — лист
+  static constexpr uint32_t kNone = 0xffffffffu;      ///< Нет родителя
+  static constexpr size_t kMaxDepth =
+      128;  ///< Глубина стека обхода (ключи 62-битные, глубина не больше 64)
+
+  /**
+   * @brief Внутренний узел: бокс и два потомка (лист — с kLeafFlag).
+   */
+  struct Node {
+    BoundingBox box;
+    uint32_t child[2] = {0, 0};
+  };
+
+  bool build(const std::vector<Vertex>& vertices,
+             std::vector<std::array<int, 2>> segments,
+             const CancellationToken* cancel) {
+    ThreadPool& pool = ThreadPool::instance();
+    size_t count = segments.size();
+    clear();
+    if (count == 0) return true;
+
+    std::vector<uint64_t> keys = sortedKeys(vertices, segments, cancel);
+    if (stopped(cancel)) return false;
+    segments_.resize(count);
+    ids_.resize(count);
+    positions_.resize(count);
+    pool.parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        uint32_t id = static_cast<uint32_t>(keys[i]);
+        segments_[i] = segments[id];
+        ids_[i] = id;
+        positions_[id] = static_cast<uint32_t>(i);
+      }
+    });
+
+    size_t leaves = (count + kLeafSize - 1) / kLeafSize;
+    leafBoxes_.resize(leaves);
+    leafParent_.assign(leaves, kNone);
+    nodes_.resize(leaves - 1);
+    nodeParent_.assign(leaves - 1, kNone);
+    std::vector<uint64_t> leafKeys(leaves);
+    for (size_t leaf = 0; leaf < leaves; ++leaf) {
+      leafKeys[leaf] = keys[leaf * kLeafSize];
+    }
+    if (stopped(cancel)) {
+      clear();
+      return false;
+    }
+    pool.parallelFor(
+        nodes_.size(), kParallelGrain / kLeafSize,
+        [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) buildNode(leafKeys, i);
+        });
+    if (stopped(cancel)) {
+      clear();
+      return false;
+    }
+    refit(vertices);
+    return true;
+  }
+
+  /**
+   * @brief Делает дерево пустым.
+   */
+  void clear() {
+    nodes_.clear();
+    leafBoxes_.clear();
+    leafParent_.clear();
+    nodeParent_.clear();
+    segments_.clear();
+    ids_.clear();
+    positions_.clear();
+  }
+
+  /**
+   * @brief Запрошена ли отмена построения.
+   */
+  static bool stopped(const CancellationToken* cancel) {
+    return cancel && cancel->cancelled();
+  }
+
+  /**
+   * @brief Пары индексов lineIndices в виде отрезков.
+   */
+  static std::vector<std::array<int, 2>> pairs(
+      const std::vector<int>& lineIndices) {
+    std::vector<std::array<int, 2>> segments(lineIndices.size() / 2);
+    ThreadPool::instance().parallelFor(
+        segments.size(), kParallelGrain, [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            segments[i] = {lineIndices[2 * i], lineIndices[2 * i + 1]};
+          }
+        });
+    return segments;
+  }
+
+  /**
+   * @brief Отсортированные ключи отрезков: код Мортона центра и номер
+   * отрезка (все ключи различны).
+   *
+   * При отмене (cancel) возвращается раньше, с неполным результатом.
+   */
+  static std::vector<uint64_t> sortedKeys(
+      const std::vector<Vertex>& vertices,
+      const std::vector<std::array<int, 2>>& segments,
+      const CancellationToken* cancel = nullptr) {
+    ThreadPool& pool = ThreadPool::instance();
+    size_t count = segments.size();
+
+    // Центры отрезков приводятся к сетке 1024^3 внутри их общего бокса
+    BoundingBox centers;
+    std::mutex mutex;
+    pool.parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+      BoundingBox part;
+      for (size_t i = begin; i < end; ++i) {
+        float c[3];
+        center(vertices, segments[i], c);
+        part.include(c[0], c[1], c[2]);
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      centers.merge(part);
+    });
+    if (stopped(cancel)) return {};
+    float scale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+      float extent = centers.max[axis] - centers.min[axis];
+      scale[axis] = extent > 0.0f ? 1023.0f / extent : 0.0f;
+    }
+
+    // Ключ — код Мортона и номер отрезка
+    std::vector<uint64_t> keys(count);
+    pool.parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        float c[3];
+        center(vertices, segments[i], c);
+        uint32_t cell[3];
+        for (int axis = 0; axis < 3; ++axis) {
+          float value = (c[axis] - centers.min[axis]) * scale[axis];
+          cell[axis] = static_cast<uint32_t>(std::clamp(value, 0.0f, 1023.0f));
+        }
+        uint64_t code = (spread(cell[0]) << 2) | (spread(cell[1]) << 1) |
+                        spread(cell[2]);
+        keys[i] = (code << 32) | i;
+      }
+    });
+    if (stopped(cancel)) return {};
+    sortKeys(keys, cancel);
+    return keys;
+  }
+
+  /**
+   * @brief Находит диапазон листьев и точку деления внутреннего узла i.
+   */
+  void buildNode(const std::vector<uint64_t>& keys, size_t index) {
+    const int64_t n = static_cast<int64_t>(keys.size());
+    const int64_t i = static_cast<int64_t>(index);
+    auto delta = [&](int64_t j) {
+      if (j < 0 || j >= n) return -1;
+      return __builtin_clzll(keys[i] ^ keys[j]);
+    };
+
+    // Направление диапазона и его длина
+    int64_t d = delta(i + 1) > delta(i - 1) ? 1 : -1;
+    int minimum = delta(i - d);
+    int64_t maxLength = 2;
+    while (delta(i + maxLength * d) > minimum) maxLength *= 2;
+    int64_t length = 0;
+    for (int64_t t = maxLength / 2; t >= 1; t /= 2) {
+      if (delta(i + (length + t) * d) > minimum) length += t;
+    }
+    int64_t j = i + length * d;
+
+    // Деление по старшему различающемуся биту
+    int common = delta(j);
+    int64_t split = 0;
+    int64_t t = length;
+    do {
+      t = (t + 1) / 2;
+      if (delta(i + (split + t) * d) > common) split += t;
+    } while (t > 1);
+    int64_t gamma = i + split * d + std::min<int64_t>(d, 0);
+
+    Node& node = nodes_[index];
+    uint32_t left = static_cast<uint32_t>(gamma);
+    uint32_t right = static_cast<uint32_t>(gamma + 1);
+    if (std::min(i, j) == gamma) {
+      node.child[0] = left | kLeafFlag;
+      leafParent_[left] = static_cast<uint32_t>(index);
+    } else {
+      node.child[0] = left;
+      nodeParent_[left] = static_cast<uint32_t>(index);
+    }
+    if (std::max(i, j) == gamma + 1) {
+      node.child[1] = right | kLeafFlag;
+      leafParent_[right] = static_cast<uint32_t>(index);
+    } else {
+      node.child[1] = right;
+      nodeParent_[right] = static_cast<uint32_t>(index);
+    }
+  }
+
+  /**
+   * @brief Сортирует ключи частями в пуле и сливает части попарно; при
+   * отмене (cancel) прекращает слияние между проходами.
+   */
+  static void sortKeys(std::vector<uint64_t>& keys,
+                       const CancellationToken* cancel) {
+    ThreadPool& pool = ThreadPool::instance();
+    size_t parts = pool.partsFor(keys.size(), kParallelGrain);
+    auto bound = [&](size_t part) { return keys.size() * part / parts; };
+    pool.parallelFor(parts, 1, [&](size_t begin, size_t end) {
+      for (size_t part = begin; part < end; ++part) {
+        std::sort(keys.begin() + bound(part), keys.begin() + bound(part + 1));
+      }
+    });
+    for (size_t width = 1; width < parts; width *= 2) {
+      if (stopped(cancel)) return;
+      size_t merges = (parts + 2 * width - 1) / (2 * width);
+      pool.parallelFor(merges, 1, [&](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; ++m) {
+          size_t first = 2 * width * m;
+          size_t middle = std::min(parts, first + width);
+          size_t last = std::min(parts, first + 2 * width);
+          if (middle == last) continue;
+          std::inplace_merge(keys.begin() + bound(first),
+                             keys.begin() + bound(middle),
+                             keys.begin() + bound(last));
+        }
+      });
+    }
+  }
+
+  /**
+   * @brief Раздвигает 10 младших бит value через два нуля (для кода
+   * Мортона).
+   */
+  static uint64_t spread(uint32_t value) {
+    uint64_t x = value & 0x3ffu;
+    x = (x | (x << 16)) & 0x30000ffu;
+    x = (x | (x << 8)) & 0x300f00fu;
+    x = (x | (x << 4)) & 0x30c30c3u;
+    x = (x | (x << 2)) & 0x9249249u;
+    return x;
+  }
+
+  static void center(const std::vector<Vertex>& vertices,
+                     const std::array<int, 2>& segment, float* c) {
+    const Vertex& a = vertices[segment[0]];
+    const Vertex& b = vertices[segment[1]];
+    c[0] = (a.x + b.x) * 0.5f;
+    c[1] = (a.y + b.y) * 0.5f;
+    c[2] = (a.z + b.z) * 0.5f;
+  }
+
+  BoundingBox leafBox(const std::vector<Vertex>& vertices,
+                      size_t leaf) const {
+    BoundingBox box;
+    size_t end = std::min(segments_.size(), (leaf + 1) * kLeafSize);
+    for (size_t i = leaf * kLeafSize; i < end; ++i) {
+      for (int index : segments_[i]) {
+        const Vertex& v = vertices[index];
+        box.include(v.x, v.y, v.z);
+      }
+    }
+    return box;
+  }
+
+  const BoundingBox& childBox(uint32_t child) const {
+    return child & kLeafFlag ? leafBoxes_[child & ~kLeafFlag]
+                             : nodes_[child].box;
+  }
+
+  /**
+   * @brief Проходит ли луч ближе limit к боксу (проверка по боксу,
+   * расширенному на limit); entry — параметр входа луча.
+   */
+  static bool near(const BoundingBox& box, const Ray& ray,
+                   const float* inverse, float limit,
+                   float* entry = nullptr) {
+    float tMin = 0.0f;
+    float tMax = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; ++axis) {
+      float low = box.min[axis] - limit, high = box.max[axis] + limit;
+      if (ray.direction[axis] == 0.0f) {
+        if (ray.origin[axis] < low || ray.origin[axis] > high) return false;
+        continue;
+      }
+      float t1 = (low - ray.origin[axis]) * inverse[axis];
+      float t2 = (high - ray.origin[axis]) * inverse[axis];
+      tMin = std::max(tMin, std::min(t1, t2));
+      tMax = std::min(tMax, std::max(t1, t2));
+      if (tMin > tMax) return false;
+    }
+    if (entry) *entry = tMin;
+    return true;
+  }
+
+  std::vector<std::array<int, 2>> segments_;  ///< Отрезки в порядке листьев
+  std::vector<uint32_t> ids_;        ///< Номер отрезка в порядке build()
+  std::vector<uint32_t> positions_;  ///< Обратная перестановка к ids_
+  std::vector<Node> nodes_;          ///< Внутренние узлы, корень — 0-й
+  std::vector<BoundingBox> leafBoxes_;  ///< Боксы листьев
+  std::vector<uint32_t> nodeParent_;    ///< Родители внутренних узлов
+  std::vector<uint32_t> leafParent_;    ///< Родители листьев
+};  // class Bvh
+
+}  // namespace s21
+
+#endif  // BVH_H
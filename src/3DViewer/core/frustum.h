@@ -0,0 +1,98 @@
+/**
+ * @file frustum.h
+ * @brief Класс Frustum — пирамида видимости камеры для отсечения частей
+ * модели по боксам.
+ */
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cmath>
+
+#include "affinetransform.h"
+#include "vertexkernels.h"
+
+namespace s21 {
+
+/**
+ * @class Frustum
+ * @brief Плоскости видимой области камеры в координатах модели.
+ *
+ * Камера смотрит вдоль -z своей системы координат, ось y направлена вверх
+ * (как у камер Qt Quick 3D). Плоскости строятся в координатах камеры и
+ * переводятся в координаты модели один раз, поэтому боксы частей модели
+ * проверяются без преобразования. Дальняя плоскость не учитывается.
+ */
+class Frustum {
+ public:
+  /**
+   * @brief Пирамида камеры с вертикальным углом обзора fieldOfView.
+   *
+   * @param fieldOfView Угол обзора в градусах; 0 — ортографическая камера,
+   * у которой единица сцены равна пикселю.
+   * @param width, height Размер области вывода в пикселях.
+   * @param cameraFromModel Преобразование координат модели в координаты
+   * камеры.
+   */
+  Frustum(float fieldOfView, float width, float height,
+          const AffineTransform& cameraFromModel) {
+    float aspect = height > 0.0f ? width / height : 1.0f;
+    // Плоскости ax + by + cz + d >= 0 внутри, в координатах камеры
+    float camera[kPlanes][4] = {{0, 0, -1, 0}};
+    if (fieldOfView > 0.0f) {
+      float t = std::tan(fieldOfView * static_cast<float>(M_PI) / 360.0f);
+      float planes[4][4] = {{1, 0, -t * aspect, 0},
+                            {-1, 0, -t * aspect, 0},
+                            {0, 1, -t, 0},
+                            {0, -1, -t, 0}};
+      for (int i = 0; i < 4; ++i) {
+        for (int k = 0; k < 4; ++k) camera[i + 1][k] = planes[i][k];
+      }
+    } else {
+      float planes[4][4] = {{1, 0, 0, width * 0.5f},
+                            {-1, 0, 0, width * 0.5f},
+                            {0, 1, 0, height * 0.5f},
+                            {0, -1, 0, height * 0.5f}};
+      for (int i = 0; i < 4; ++i) {
+        for (int k = 0; k < 4; ++k) camera[i + 1][k] = planes[i][k];
+      }
+    }
+
+    // Плоскость p в координатах модели: p * M (M дополнена строкой 0 0 0 1)
+    const auto& m = cameraFromModel.m;
+    for (int i = 0; i < kPlanes; ++i) {
+      const float* p = camera[i];
+      for (int j = 0; j < 4; ++j) {
+        planes_[i][j] = p[0] * m[0][j] + p[1] * m[1][j] + p[2] * m[2][j];
+      }
+      planes_[i][3] += p[3];
+    }
+  }
+
+  /**
+   * @brief Пересекает ли бокс видимую область (с запасом: бокс у угла
+   * пирамиды может быть признан видимым).
+   */
+  bool intersects(const BoundingBox& box) const {
+    if (box.empty()) return false;
+    for (const auto& plane : planes_) {
+      // Угол бокса, дальше всех выступающий внутрь плоскости
+      float distance = plane[3];
+      for (int axis = 0; axis < 3; ++axis) {
+        distance += plane[axis] *
+                    (plane[axis] >= 0.0f ? box.max[axis] : box.min[axis]);
+      }
+      if (distance < 0.0f) return false;
+    }
+    return true;
+  }
+
+ private:
+  static constexpr int kPlanes = 5;  ///< Ближняя и четыре боковые
+
+  float planes_[kPlanes][4];  ///< Плоскости в координатах модели
+};  // class Frustum
+
+}  // namespace s21
+
+#endif  // FRUSTUM_H
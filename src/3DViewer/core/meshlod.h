@@ -0,0 +1,121 @@
+/**
+ * @file meshlod.h
+ * @brief Класс MeshLod — цепочка уровней детализации модели и выбор уровня
+ * по размеру модели на экране.
+ */
+
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "meshsimplifier.h"
+#include "model3d.h"
+#include "threadpool.h"
+
+namespace s21 {
+
+/**
+ * @class MeshLod
+ * @brief Строит упрощённые копии плотной модели и выбирает, какую из них
+ * показывать.
+ *
+ * Уровень 0 — исходная модель, каждый следующий уровень содержит примерно
+ * в 1 / kReduction раз меньше граней (MeshSimplifier). Показывается самый
+ * подробный уровень, число граней которого не превышает бюджета
+ * kFacesPerPixel граней на пиксель площади модели на экране, поэтому
+ * исходная модель используется только при достаточном приближении.
+ */
+class MeshLod {
+ public:
+  static constexpr size_t kMinFaces =
+      50000;  ///< Модели с меньшим числом граней не упрощаются
+  static constexpr double kReduction =
+      0.25;  ///< Доля граней следующего уровня от предыдущего
+  static constexpr size_t kMaxLevels =
+      5;  ///< Наибольшее число уровней, включая исходную модель
+  static constexpr double kFacesPerPixel =
+      0.25;  ///< Бюджет граней на пиксель площади модели на экране
+
+  /**
+   * @brief Строит упрощённые уровни модели (без уровня 0).
+   *
+   * Уровни строятся одним MeshSimplifier последовательно, пока число
+   * граней больше kMinFaces. Для модели меньше kMinFaces граней результат
+   * пуст.
+   *
+   * @param model Исходная модель (координаты без Model3D::transform).
+   * @param levels Результат: уровни 1, 2, ...
+   * @param cancel Токен отмены (может быть nullptr).
+   * @return false если построение отменено.
+   */
+  static bool buildChain(const Model3D& model, std::vector<Model3D>& levels,
+                         const CancellationToken* cancel = nullptr) {
+    levels.clear();
+    if (model.polygons.size() < kMinFaces) return true;
+
+    MeshSimplifier simplifier(model);
+    size_t faces = simplifier.faceCount();
+    while (levels.size() + 1 < kMaxLevels && faces > kMinFaces) {
+      size_t target = static_cast<size_t>(faces * kReduction);
+      if (!simplifier.simplify(target, cancel)) return false;
+      if (simplifier.faceCount() >= faces) break;  // Упрощать больше нечего
+      faces = simplifier.faceCount();
+      levels.push_back(simplifier.result());
+    }
+    return true;
+  }
+
+  /**
+   * @brief Число треугольников модели после триангуляции граней веером.
+   */
+  static size_t triangleCount(const PolygonList& polygons) {
+    size_t count = 0;
+    for (PolygonView polygon : polygons) {
+      if (polygon.size() > 2) count += polygon.size() - 2;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Размер нормализованной модели на экране в пикселях.
+   *
+   * @param scale Масштаб узла сцены (ползунок масштаба).
+   * @param distance Расстояние от камеры до модели.
+   * @param fieldOfView Вертикальный угол обзора камеры в градусах; 0 для
+   * ортографической камеры (единица сцены — пиксель).
+   * @param viewportHeight Высота области вывода в пикселях.
+   */
+  static double projectedSize(double scale, double distance,
+                              double fieldOfView, double viewportHeight) {
+    double size = Model3D::kNormalizedSize * scale;
+    if (fieldOfView <= 0.0) return size;
+    double halfAngle = fieldOfView * M_PI / 360.0;
+    double visible = 2.0 * std::max(distance, 1e-6) * std::tan(halfAngle);
+    return size / visible * viewportHeight;
+  }
+
+  /**
+   * @brief Выбирает уровень для модели размером projectedSize пикселей.
+   *
+   * @param faceCounts Число граней уровней, начиная с исходной модели.
+   * @return Самый подробный уровень в пределах бюджета или последний
+   * уровень, если бюджет меньше всех.
+   */
+  static size_t levelFor(double projectedSize,
+                         const std::vector<size_t>& faceCounts) {
+    if (faceCounts.empty()) return 0;
+    double budget = kFacesPerPixel * projectedSize * projectedSize;
+    for (size_t level = 0; level < faceCounts.size(); ++level) {
+      if (faceCounts[level] <= budget) return level;
+    }
+    return faceCounts.size() - 1;
+  }
+};  // class MeshLod
+
+}  // namespace s21
+
+#endif  // MESH_LOD_H
@@ -0,0 +1,531 @@
+/**
+ * @file meshsimplifier.h
+ * @brief Класс MeshSimplifier — упрощение сетки стягиванием рёбер по
+ * квадрикам ошибки (QEM, Garland–Heckbert).
+ */
+
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "model3d.h"
+#include "threadpool.h"
+
+namespace s21 {
+
+/**
+ * @brief Квадрика ошибки: сумма квадратов расстояний до набора плоскостей
+ * в виде симметричной матрицы 4x4 (10 коэффициентов).
+ */
+struct Quadric {
+  /// a², ab, ac, ad, b², bc, bd, c², cd, d²
+  double q[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+  /**
+   * @brief Квадрика плоскости ax + by + cz + d = 0 с весом weight.
+   */
+  static Quadric plane(double a, double b, double c, double d,
+                       double weight = 1.0) {
+    Quadric result;
+    const double p[4] = {a, b, c, d};
+    int k = 0;
+    for (int i = 0; i < 4; ++i) {
+      for (int j = i; j < 4; ++j) result.q[k++] = weight * p[i] * p[j];
+    }
+    return result;
+  }
+
+  Quadric& operator+=(const Quadric& other) {
+    for (int i = 0; i < 10; ++i) q[i] += other.q[i];
+    return *this;
+  }
+
+  Quadric operator+(const Quadric& other) const {
+    Quadric result = *this;
+    result += other;
+    return result;
+  }
+
+  /**
+   * @brief Ошибка в точке (x, y, z).
+   */
+  double error(double x, double y, double z) const {
+    return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z +
+           2 * q[3] * x + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y +
+           q[7] * z * z + 2 * q[8] * z + q[9];
+  }
+
+  /**
+   * @brief Точка минимума ошибки.
+   * @return false если матрица вырождена и минимум не единственный.
+   */
+  bool minimum(double& x, double& y, double& z) const {
+    // Решаем A p = -b методом Крамера
+    double a00 = q[0], a01 = q[1], a02 = q[2];
+    double a11 = q[4], a12 = q[5], a22 = q[7];
+    double b0 = -q[3], b1 = -q[6], b2 = -q[8];
+    double c00 = a11 * a22 - a12 * a12;
+    double c01 = a02 * a12 - a01 * a22;
+    double c02 = a01 * a12 - a02 * a11;
+    double det = a00 * c00 + a01 * c01 + a02 * c02;
+    double scale = std::abs(a00) + std::abs(a11) + std::abs(a22);
+    if (std::abs(det) <= 1e-12 * scale * scale * scale) return false;
+    double c11 = a00 * a22 - a02 * a02;
+    double c12 = a01 * a02 - a00 * a12;
+    double c22 = a00 * a11 - a01 * a01;
+    x = (c00 * b0 + c01 * b1 + c02 * b2) / det;
+    y = (c01 * b0 + c11 * b1 + c12 * b2) / det;
+    z = (c02 * b0 + c12 * b1 + c22 * b2) / det;
+    return true;
+  }
+};
+
+/**
+ * @class MeshSimplifier
+ * @brief Уменьшает число граней модели стягиванием рёбер с наименьшей
+ * квадратичной ошибкой.
+ *
+ * Грани триангулируются веером; грани меньше чем из трёх вершин (линии,
+ * точки) в упрощении не участвуют. Каждое ребро стягивается в точку
+ * минимума суммы квадрик концов; края открытых поверхностей закреплены
+ * дополнительными перпендикулярными плоскостями, а стягивания,
+ * переворачивающие соседние треугольники, отклоняются.
+ *
+ * simplify() можно вызывать несколько раз с убывающей целью: каждый вызов
+ * продолжает с достигнутого состояния, поэтому цепочка уровней детализации
+ * строится за один проход.
+ *
+ * Память линейна по размеру сетки без выделений на вершину: треугольники
+ * вершин хранятся одним массивом CSR, рёбра перечисляются по этим спискам
+ * (как в convertToUniqueLines()), а очередь кандидатов очищается от
+ * устаревших записей, когда перерастает число рёбер живых треугольников.
+ */
+class MeshSimplifier {
+ public:
+  /**
+   * @brief Готовит модель к упрощению (координаты без Model3D::transform).
+   */
+  explicit MeshSimplifier(const Model3D& model)
+      : positions_(model.vertices.size()),
+        quadrics_(model.vertices.size()),
+        versions_(model.vertices.size(), 0),
+        alive_(model.vertices.size(), true) {
+    for (size_t i = 0; i < model.vertices.size(); ++i) {
+      const Vertex& v = model.vertices[i];
+      positions_[i] = {v.x, v.y, v.z};
+    }
+    size_t fan = 0;
+    for (PolygonView polygon : model.polygons) {
+      if (polygon.size() >= 3) fan += polygon.size() - 2;
+    }
+    triangles_.reserve(fan);
+    for (PolygonView polygon : model.polygons) {
+      for (size_t k = 1; k + 1 < polygon.size(); ++k) {
+        std::array<int, 3> triangle = {polygon[0], polygon[k], polygon[k + 1]};
+        if (triangle[0] == triangle[1] || triangle[1] == triangle[2] ||
+            triangle[0] == triangle[2]) {
+          continue;
+        }
+        triangles_.push_back(triangle);
+      }
+    }
+    faceAlive_.assign(triangles_.size(), true);
+    liveFaces_ = triangles_.size();
+    buildAdjacency();
+    buildQuadrics();
+    forEachEdge([this](int a, int b, size_t, int) { pushCandidate(a, b); });
+  }
+
+  /**
+   * @brief Число оставшихся треугольников.
+   */
+  size_t faceCount() const { return liveFaces_; }
+
+  /**
+   * @brief Стягивает рёбра, пока треугольников больше targetFaces.
+   *
+   * Останавливается раньше, если допустимых стягиваний не осталось.
+   *
+   * @param cancel Токен отмены; проверяется каждые kCancelCheck стягиваний.
+   * @return false если упрощение отменено.
+   */
+  bool simplify(size_t targetFaces, const CancellationToken* cancel = nullptr) {
+    size_t collapses = 0;
+    while (liveFaces_ > targetFaces && !heap_.empty()) {
+      if (cancel && ++collapses % kCancelCheck == 0 && cancel->cancelled()) {
+        return false;
+      }
+      std::pop_heap(heap_.begin(), heap_.end(), std::greater<Candidate>());
+      Candidate candidate = heap_.back();
+      heap_.pop_back();
+      if (stale(candidate)) continue;  // Концы уже изменились
+      collapse(candidate.u, candidate.v);
+      if (heap_.size() > std::max(kHeapSlack * 3 * liveFaces_, kMinHeap)) {
+        compactHeap();
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Текущее состояние в виде модели: только используемые вершины,
+   * грани — треугольники.
+   */
+  Model3D result() const {
+    Model3D model;
+    std::vector<int> remap(positions_.size(), -1);
+    std::vector<uint32_t> ends;
+    std::vector<int> indices;
+    ends.reserve(liveFaces_);
+    indices.reserve(3 * liveFaces_);
+    for (size_t face = 0; face < triangles_.size(); ++face) {
+      if (!faceAlive_[face]) continue;
+      for (int vertex : triangles_[face]) {
+        if (remap[vertex] < 0) {
+          remap[vertex] = static_cast<int>(model.vertices.size());
+          const auto& p = positions_[vertex];
+          model.vertices.emplace_back(p[0], p[1], p[2]);
+        }
+        indices.push_back(remap[vertex]);
+      }
+      ends.push_back(static_cast<uint32_t>(indices.size()));
+    }
+    model.polygons.assign(std::move(ends), std::move(indices));
+    model.resetPosition();
+    return model;
+  }
+
+  static constexpr size_t kCancelCheck =
+      1024;  ///< Период проверки токена отмены (в стягиваниях)
+  static constexpr double kBoundaryWeight =
+      1000.0;  ///< Вес плоскостей, закрепляющих края поверхности
+  static constexpr double kLengthWeight =
+      1e-6;  ///< Вес длины ребра, упорядочивающий стягивания без ошибки
+  static constexpr size_t kHeapSlack =
+      2;  ///< Допустимое число записей очереди на ребро живых треугольников
+  static constexpr size_t kMinHeap =
+      1024;  ///< Размер очереди, до которого она не очищается
+
+ private:
+  /**
+   * @brief Кандидат на стягивание ребра (u, v); точка стягивания
+   * пересчитывается при извлечении (20 байт вместо 40).
+   */
+  struct Candidate {
+    float cost;
+    int u, v;
+    uint32_t versionU, versionV;  ///< Версии концов на момент расчёта
+
+    bool operator>(const Candidate& other) const { return cost > other.cost; }
+  };
+
+  using Position = std::array<float, 3>;
+
+  /**
+   * @brief Списки треугольников вершин в форме CSR.
+   *
+   * Треугольники исходной вершины m лежат в faces_[faceBegin_[m],
+   * faceEnd_[m]). Стянутая вершина не переносит свой список, а
+   * присоединяется к цепочке next_ вершины, в которую стянута.
+   */
+  void buildAdjacency() {
+    size_t count = positions_.size();
+    faceBegin_.assign(count + 1, 0);
+    for (const auto& triangle : triangles_) {
+      for (int vertex : triangle) ++faceBegin_[vertex + 1];
+    }
+    for (size_t i = 0; i < count; ++i) faceBegin_[i + 1] += faceBegin_[i];
+    faceEnd_.assign(faceBegin_.begin(), faceBegin_.end() - 1);
+    faces_.resize(faceBegin_[count]);
+    for (size_t face = 0; face < triangles_.size(); ++face) {
+      for (int vertex : triangles_[face]) {
+        faces_[faceEnd_[vertex]++] = static_cast<int>(face);
+      }
+    }
+    next_.assign(count, -1);
+  }
+
+  /**
+   * @brief Вызывает visit(face) для живых треугольников вершины vertex.
+   */
+  template <typename Visit>
+  void forEachFace(int vertex, Visit&& visit) const {
+    for (int member = vertex; member >= 0; member = next_[member]) {
+      for (uint32_t i = faceBegin_[member]; i < faceEnd_[member]; ++i) {
+        if (faceAlive_[faces_[i]]) visit(faces_[i]);
+      }
+    }
+  }
+
+  /**
+   * @brief Убирает удалённые треугольники из списков цепочки vertex и
+   * исключает из неё вершины с опустевшими списками.
+   */
+  void compactFaces(int vertex) {
+    int previous = -1;
+    for (int member = vertex; member >= 0;) {
+      uint32_t end = faceBegin_[member];
+      for (uint32_t i = faceBegin_[member]; i < faceEnd_[member]; ++i) {
+        if (faceAlive_[faces_[i]]) faces_[end++] = faces_[i];
+      }
+      faceEnd_[member] = end;
+      int following = next_[member];
+      if (end == faceBegin_[member] && previous >= 0) {
+        next_[previous] = following;
+        next_[member] = -1;
+      } else {
+        previous = member;
+      }
+      member = following;
+    }
+  }
+
+  /**
+   * @brief Вызывает visit(a, b, faceCount, face) для каждого ребра (a < b)
+   * один раз; face — один из faceCount треугольников ребра.
+   */
+  template <typename Visit>
+  void forEachEdge(Visit&& visit) const {
+    std::vector<std::pair<int, int>> ends;  // (b, грань) рёбер вершины a
+    for (size_t i = 0; i < positions_.size(); ++i) {
+      int a = static_cast<int>(i);
+      ends.clear();
+      forEachFace(a, [&](int face) {
+        for (int b : triangles_[face]) {
+          if (b > a) ends.emplace_back(b, face);
+        }
+      });
+      std::sort(ends.begin(), ends.end());
+      for (size_t j = 0; j < ends.size();) {
+        size_t k = j + 1;
+        while (k < ends.size() && ends[k].first == ends[j].first) ++k;
+        visit(a, ends[j].first, k - j, ends[j].second);
+        j = k;
+      }
+    }
+  }
+
+  /**
+   * @brief Нормаль треугольника (не нормированная, длина — удвоенная
+   * площадь).
+   */
+  static std::array<double, 3> normal(const Position& a, const Position& b,
+                                      const Position& c) {
+    double ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+    double vx = c[0] - a[0], vy = c[1] - a[1], vz = c[2] - a[2];
+    return {uy * vz - uz * vy, uz * vx - ux * vz, ux * vy - uy * vx};
+  }
+
+  /**
+   * @brief Квадрики вершин из плоскостей граней и плоскостей краёв.
+   */
+  void buildQuadrics() {
+    for (size_t face = 0; face < triangles_.size(); ++face) {
+      const auto& t = triangles_[face];
+      auto n = normal(positions_[t[0]], positions_[t[1]], positions_[t[2]]);
+      double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      if (length == 0.0) continue;
+      double a = n[0] / length, b = n[1] / length, c = n[2] / length;
+      const Position& p = positions_[t[0]];
+      double d = -(a * p[0] + b * p[1] + c * p[2]);
+      Quadric plane = Quadric::plane(a, b, c, d, length * 0.5);
+      for (int vertex : t) quadrics_[vertex] += plane;
+    }
+    // Ребро-край принадлежит ровно одному треугольнику
+    forEachEdge([this](int a, int b, size_t faceCount, int face) {
+      if (faceCount == 1) addBoundaryPlane(a, b, face);
+    });
+  }
+
+  /**
+   * @brief Закрепляет край (a, b) грани face плоскостью, проходящей через
+   * ребро перпендикулярно грани.
+   */
+  void addBoundaryPlane(int a, int b, int face) {
+    const auto& t = triangles_[face];
+    auto n = normal(positions_[t[0]], positions_[t[1]], positions_[t[2]]);
+    const Position& pa = positions_[a];
+    const Position& pb = positions_[b];
+    double ex = pb[0] - pa[0], ey = pb[1] - pa[1], ez = pb[2] - pa[2];
+    double px = ey * n[2] - ez * n[1];
+    double py = ez * n[0] - ex * n[2];
+    double pz = ex * n[1] - ey * n[0];
+    double length = std::sqrt(px * px + py * py + pz * pz);
+    if (length == 0.0) return;
+    px /= length, py /= length, pz /= length;
+    double d = -(px * pa[0] + py * pa[1] + pz * pa[2]);
+    double edgeLength2 = ex * ex + ey * ey + ez * ez;
+    Quadric plane =
+        Quadric::plane(px, py, pz, d, kBoundaryWeight * edgeLength2);
+    quadrics_[a] += plane;
+    quadrics_[b] += plane;
+  }
+
+  /**
+   * @brief Точка стягивания ребра (u, v) и её ошибка.
+   */
+  double placement(int u, int v, Position& target) const {
+    Quadric sum = quadrics_[u] + quadrics_[v];
+    const Position& pu = positions_[u];
+    const Position& pv = positions_[v];
+    double x = 0, y = 0, z = 0;
+    double cost;
+    if (sum.minimum(x, y, z)) {
+      cost = sum.error(x, y, z);
+    } else {
+      // Вырожденная квадрика: лучшая из середины и концов
+      const double options[3][3] = {
+          {(pu[0] + pv[0]) * 0.5, (pu[1] + pv[1]) * 0.5,
+           (pu[2] + pv[2]) * 0.5},
+          {pu[0], pu[1], pu[2]},
+          {pv[0], pv[1], pv[2]}};
+      cost = std::numeric_limits<double>::max();
+      for (const auto& option : options) {
+        double error = sum.error(option[0], option[1], option[2]);
+        if (error < cost) {
+          cost = error;
+          x = option[0], y = option[1], z = option[2];
+        }
+      }
+    }
+    // На плоских участках ошибка нулевая у всех рёбер: короткие рёбра
+    // стягиваются первыми, иначе вершины собираются в одну «звезду»
+    double ex = pu[0] - pv[0], ey = pu[1] - pv[1], ez = pu[2] - pv[2];
+    target = {static_cast<float>(x), static_cast<float>(y),
+              static_cast<float>(z)};
+    return std::max(cost, 0.0) + kLengthWeight * (ex * ex + ey * ey + ez * ez);
+  }
+
+  /**
+   * @brief Добавляет стягивание ребра (u, v) в очередь.
+   */
+  void pushCandidate(int u, int v) {
+    Position target;
+    float cost = static_cast<float>(placement(u, v, target));
+    heap_.push_back(Candidate{cost, u, v, versions_[u], versions_[v]});
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<Candidate>());
+  }
+
+  /**
+   * @brief Кандидат устарел: конец стянут или изменился после расчёта.
+   */
+  bool stale(const Candidate& candidate) const {
+    return !alive_[candidate.u] || !alive_[candidate.v] ||
+           versions_[candidate.u] != candidate.versionU ||
+           versions_[candidate.v] != candidate.versionV;
+  }
+
+  /**
+   * @brief Удаляет из очереди устаревших кандидатов.
+   *
+   * Каждое стягивание оставляет в очереди записи о прежних рёбрах вершины.
+   * Живых кандидатов не больше, чем рёбер живых треугольников (3 на
+   * треугольник), поэтому очистка при превышении этого числа в kHeapSlack
+   * раз держит очередь пропорциональной текущей сетке.
+   */
+  void compactHeap() {
+    heap_.erase(std::remove_if(heap_.begin(), heap_.end(),
+                               [this](const Candidate& candidate) {
+                                 return stale(candidate);
+                               }),
+                heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), std::greater<Candidate>());
+  }
+
+  /**
+   * @brief Переворачивает ли перенос вершины в target какой-либо из её
+   * треугольников, не содержащих other.
+   */
+  bool flips(int vertex, int other, const Position& target) const {
+    for (int member = vertex; member >= 0; member = next_[member]) {
+      for (uint32_t i = faceBegin_[member]; i < faceEnd_[member]; ++i) {
+        int face = faces_[i];
+        if (!faceAlive_[face]) continue;
+        const auto& t = triangles_[face];
+        if (t[0] == other || t[1] == other || t[2] == other) continue;
+        Position moved[3];
+        for (int k = 0; k < 3; ++k) {
+          moved[k] = t[k] == vertex ? target : positions_[t[k]];
+        }
+        auto before =
+            normal(positions_[t[0]], positions_[t[1]], positions_[t[2]]);
+        auto after = normal(moved[0], moved[1], moved[2]);
+        if (before[0] * after[0] + before[1] * after[1] +
+                before[2] * after[2] <=
+            0.0) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Стягивает v в u и пересчитывает кандидатов вокруг u.
+   */
+  void collapse(int u, int v) {
+    Position target;
+    placement(u, v, target);
+    if (flips(u, v, target) || flips(v, u, target)) return;
+
+    positions_[u] = target;
+    quadrics_[u] += quadrics_[v];
+    alive_[v] = false;
+    ++versions_[u];
+
+    forEachFace(v, [&](int face) {
+      auto& t = triangles_[face];
+      if (t[0] == u || t[1] == u || t[2] == u) {
+        faceAlive_[face] = false;  // Треугольник на стянутом ребре исчез
+        --liveFaces_;
+        return;
+      }
+      for (int& vertex : t) {
+        if (vertex == v) vertex = u;
+      }
+    });
+
+    // Присоединяем цепочку v к цепочке u и собираем соседей
+    int tail = v;
+    while (next_[tail] >= 0) tail = next_[tail];
+    next_[tail] = next_[u];
+    next_[u] = v;
+    compactFaces(u);
+    neighbours_.clear();
+    forEachFace(u, [this, u](int face) {
+      for (int vertex : triangles_[face]) {
+        if (vertex != u) neighbours_.push_back(vertex);
+      }
+    });
+    std::sort(neighbours_.begin(), neighbours_.end());
+    neighbours_.erase(std::unique(neighbours_.begin(), neighbours_.end()),
+                      neighbours_.end());
+    for (int neighbour : neighbours_) pushCandidate(u, neighbour);
+  }
+
+  std::vector<Position> positions_;            ///< Координаты вершин
+  std::vector<Quadric> quadrics_;              ///< Квадрики вершин
+  std::vector<uint32_t> faceBegin_;            ///< Начала списков в faces_
+  std::vector<uint32_t> faceEnd_;              ///< Концы списков в faces_
+  std::vector<int> faces_;                     ///< Треугольники вершин (CSR)
+  std::vector<int> next_;                      ///< Следующая в цепочке стяжки
+  std::vector<uint32_t> versions_;             ///< Счётчик изменений вершин
+  std::vector<bool> alive_;                    ///< Вершина не стянута
+  std::vector<std::array<int, 3>> triangles_;  ///< Треугольники
+  std::vector<bool> faceAlive_;                ///< Треугольник не удалён
+  size_t liveFaces_ = 0;                       ///< Число живых треугольников
+  std::vector<Candidate> heap_;  ///< Кандидаты по возрастанию ошибки (куча)
+  std::vector<int> neighbours_;  ///< Буфер соседей для collapse()
+};  // class MeshSimplifier
+
+}  // namespace s21
+
+#endif  // MESH_SIMPLIFIER_H
@@ -9,15 +9,27 @@
 
 #include <QMetaType>
 #include <QtQml>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#include "affinetransform.h"
+#include "modeltransform.h"
+#include "vertexkernels.h"
+
 namespace s21 {
 
 /**
  * @brief Класс, представляющий вершину в 3D пространстве.
+ *
+ * Тривиально копируемый тип из трёх float подряд: массивы вершин
+ * копируются через memcpy и передаются в буфер вершин геометрии целиком.
  */
 class Vertex {
  public:
@@ -28,23 +40,6 @@ class Vertex {
    */
   Vertex(float x = 0.0f, float y = 0.0f, float z = 0.0f) : x(x), y(y), z(z) {}
 
-  /**
-   * @brief Конструктор копирования.
-   */
-  Vertex(const Vertex& other) : x(other.x), y(other.y), z(other.z) {}
-
-  /**
-   * @brief Оператор присваивания.
-   */
-  Vertex& operator=(const Vertex& other) {
-    if (this != &other) {  // Защита от самоприсваивания
-      x = other.x;
-      y = other.y;
-      z = other.z;
-    }
-    return *this;
-  }
-
   /**
    * @brief Вычитание двух вершин.
    */
@@ -107,6 +102,12 @@ class Vertex {
   }
 };  // class Vertex
 
+static_assert(sizeof(Vertex) == 3 * sizeof(float),
+              "Vertex must be laid out as three consecutive floats");
+static_assert(std::is_trivially_copyable_v<Vertex> &&
+                  std::is_standard_layout_v<Vertex>,
+              "Vertex arrays are copied and uploaded as raw bytes");
+
 /**
  * @brief Класс, представляющий грань (полигон) модели.
  */
@@ -185,17 +186,257 @@ class Polygon {
   }
 };  // class Polygon
 
+/**
+ * @brief Невладеющее представление грани, хранящейся в PolygonList.
+ *
+ * Повторяет интерфейс Polygon для чтения: размер, перебор и доступ к
+ * индексам вершин по номеру.
+ */
+class PolygonView {
+ public:
+  using value_type = int;
+  using const_iterator = std::span<const int>::iterator;
+  using iterator = const_iterator;
+
+  std::span<const int> vertexIndices;  ///< Индексы вершин грани
+
+  /**
+   * @brief Конструктор по диапазону индексов.
+   */
+  PolygonView(std::span<const int> indices = {}) : vertexIndices(indices) {}
+
+  /**
+   * @brief Представление полигона, хранящего собственные индексы.
+   */
+  PolygonView(const Polygon& polygon) : vertexIndices(polygon.vertexIndices) {}
+
+  /**
+   * @brief Печать полигона.
+   */
+  void printP() const {
+    std::cout << "Polygon: ";
+    for (int index : vertexIndices) {
+      std::cout << index << " ";
+    }
+    std::cout << "\n";
+  }
+
+  /**
+   * @brief Возвращает количество вершин в полигоне.
+   */
+  size_t size() const { return vertexIndices.size(); }
+
+  /**
+   * @brief Проверка на пустоту.
+   */
+  bool empty() const { return vertexIndices.empty(); }
+
+  /**
+   * @brief Итератор для перебора индексов вершин.
+   */
+  const_iterator begin() const { return vertexIndices.begin(); }
+
+  /**
+   * @brief Итератор для перебора индексов вершин.
+   */
+  const_iterator end() const { return vertexIndices.end(); }
+
+  /**
+   * @brief Доступ к индексу вершины по индексу.
+   * @throw std::out_of_range если индекс вне диапазона.
+   */
+  const int& operator[](size_t index) const {
+    if (index >= vertexIndices.size()) {
+      throw std::out_of_range("Index out of range in Polygon");
+    }
+    return vertexIndices[index];
+  }
+
+  /**
+   * @brief Сравнение индексов вершин двух граней.
+   */
+  bool operator==(const PolygonView& other) const {
+    return std::ranges::equal(vertexIndices, other.vertexIndices);
+  }
+};  // class PolygonView
+
+/**
+ * @brief Грани модели в сжатом построчном формате (CSR).
+ *
+ * Индексы вершин всех граней лежат подряд в одном массиве, а для каждой
+ * грани хранится только смещение её конца. В отличие от
+ * std::vector<Polygon> добавление грани не выделяет память под отдельный
+ * вектор, а перебор граней идёт по непрерывной памяти.
+ *
+ * Доступ к граням — через PolygonView; интерфейс контейнера (size(),
+ * operator[], перебор в range-for) совпадает с прежним std::vector<Polygon>.
+ */
+class PolygonList {
+ public:
+  /**
+   * @brief Итератор по граням, возвращающий PolygonView.
+   */
+  class const_iterator {
+   public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = PolygonView;
+    using difference_type = std::ptrdiff_t;
+    using reference = PolygonView;
+
+    const_iterator() = default;
+    const_iterator(const int* indices, const uint32_t* end, uint32_t begin)
+        : indices_(indices), end_(end), begin_(begin) {}
+
+    PolygonView operator*() const {
+      return PolygonView(std::span<const int>(indices_ + begin_,
+                                              *end_ - begin_));
+    }
+
+    const_iterator& operator++() {
+      begin_ = *end_++;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return end_ == other.end_;
+    }
+
+   private:
+    const int* indices_ = nullptr;  ///< Начало массива индексов
+    const uint32_t* end_ = nullptr;  ///< Смещение конца текущей грани
+    uint32_t begin_ = 0;             ///< Смещение начала текущей грани
+  };
+
+  using value_type = PolygonView;
+  using iterator = const_iterator;
+
+  /**
+   * @brief Возвращает количество граней.
+   */
+  size_t size() const { return ends_.size(); }
+
+  /**
+   * @brief Проверка на отсутствие граней.
+   */
+  bool empty() const { return ends_.empty(); }
+
+  /**
+   * @brief Суммарное количество индексов вершин всех граней.
+   */
+  size_t indexCount() const { return indices_.size(); }
+
+  /**
+   * @brief Возвращает грань по номеру (без проверки диапазона).
+   */
+  PolygonView operator[](size_t index) const {
+    uint32_t begin = index ? ends_[index - 1] : 0;
+    return PolygonView(
+        std::span<const int>(indices_.data() + begin, ends_[index] - begin));
+  }
+
+  const_iterator begin() const {
+    return const_iterator(indices_.data(), ends_.data(), 0);
+  }
+
+  const_iterator end() const {
+    return const_iterator(indices_.data(), ends_.data() + ends_.size(),
+                          ends_.empty() ? 0 : ends_.back());
+  }
+
+  /**
+   * @brief Добавляет грань с указанными индексами вершин.
+   * @throw std::length_error если общее число индексов превышает 2^32 - 1.
+   */
+  void push_back(std::span<const int> vertexIndices) {
+    if (vertexIndices.size() > UINT32_MAX - indices_.size()) {
+      throw std::length_error("Too many polygon indices");
+    }
+    indices_.insert(indices_.end(), vertexIndices.begin(),
+                    vertexIndices.end());
+    ends_.push_back(static_cast<uint32_t>(indices_.size()));
+  }
+
+  /**
+   * @brief Добавляет копию полигона.
+   */
+  void push_back(const Polygon& polygon) {
+    push_back(std::span<const int>(polygon.vertexIndices));
+  }
+
+  /**
+   * @brief Заменяет содержимое готовыми массивами CSR без копирования.
+   * @param ends Смещения концов граней (неубывающие).
+   * @param indices Индексы вершин всех граней подряд.
+   * @throw std::invalid_argument если смещения не согласованы с индексами.
+   */
+  void assign(std::vector<uint32_t> ends, std::vector<int> indices) {
+    if (!std::is_sorted(ends.begin(), ends.end()) ||
+        (ends.empty() ? !indices.empty() : ends.back() != indices.size())) {
+      throw std::invalid_argument("Inconsistent polygon offsets");
+    }
+    ends_ = std::move(ends);
+    indices_ = std::move(indices);
+  }
+
+  /**
+   * @brief Резервирует память под грани и их индексы.
+   */
+  void reserve(size_t polygonCount, size_t indexCount = 0) {
+    ends_.reserve(polygonCount);
+    indices_.reserve(indexCount);
+  }
+
+  /**
+   * @brief Удаляет все грани.
+   */
+  void clear() {
+    ends_.clear();
+    indices_.clear();
+  }
+
+  /**
+   * @brief Индексы вершин всех граней подряд.
+   */
+  const std::vector<int>& indices() const { return indices_; }
+
+  /**
+   * @brief Смещения концов граней в массиве indices().
+   */
+  const std::vector<uint32_t>& ends() const { return ends_; }
+
+  /**
+   * @brief Объём памяти, занимаемой массивами граней, в байтах.
+   */
+  size_t memoryBytes() const {
+    return ends_.capacity() * sizeof(uint32_t) +
+           indices_.capacity() * sizeof(int);
+  }
+
+ private:
+  std::vector<uint32_t> ends_;  ///< Смещение конца каждой грани
+  std::vector<int> indices_;    ///< Индексы вершин всех граней
+};  // class PolygonList
+
 /**
  * @brief Базовый класс для хранения и обработки 3D-модели.
  */
 class Model3D {
   Q_GADGET
  public:
-  std::vector<Vertex> vertices;   ///< Все вершины модели
-  std::vector<Polygon> polygons;  ///< Все полигоны модели
-  std::vector<Vertex>
-      currentPosition;  ///< Текущая позиция вершин (учитывая трансформации)
-  Vertex previousShift;  ///< Предыдущее смещение модели
+  std::vector<Vertex> vertices;  ///< Вершины модели (текущая позиция)
+  PolygonList polygons;          ///< Все полигоны модели
+  Vertex previousShift;          ///< Предыдущее смещение модели
+  ModelTransform transform;  ///< Отложенные поворот и сдвиг (не в вершинах)
+
+  static constexpr float kNormalizedSize =
+      12.0f;  ///< Размер модели после normalizeModel()
 
  public:
   /**
@@ -208,6 +449,15 @@ class Model3D {
    */
   ~Model3D() = default;
 
+  Model3D(const Model3D&) = default;
+  Model3D& operator=(const Model3D&) = default;
+
+  /**
+   * @brief Перемещение модели без копирования вершин и полигонов.
+   */
+  Model3D(Model3D&&) noexcept = default;
+  Model3D& operator=(Model3D&&) noexcept = default;
+
  public:
   /**
    * @brief Центрирует модель по центру координат.
@@ -218,70 +468,147 @@ class Model3D {
     Vertex center = calculateCenter();
 
     // Сдвигаем все вершины к центру координат
-    for (auto& vertex : vertices) {
-      vertex -= center;
-    }
+    AffineTransform toOrigin =
+        AffineTransform::translation(-center.x, -center.y, -center.z);
+    VertexKernels::transform(toOrigin, coords(vertices), coords(vertices),
+                             vertices.size());
+
+    // Центрированные вершины — новая позиция для поворотов
+    shiftAnchor = toOrigin * rotationAboutCenter() * shiftAnchor;
+    rotationSinceShift = PreciseRotation();
+    positionCenter = Vertex(0, 0, 0);
+  }
+
+  /**
+   * @brief Вычисляет параметры нормализации для набора вершин.
+   *
+   * Центр — середина ограничивающего бокса, масштаб приводит наибольший
+   * размер бокса к kNormalizedSize.
+   *
+   * @param points Вершины (например, уже загруженная часть модели).
+   * @param center Центр ограничивающего бокса.
+   * @param scaleFactor Коэффициент масштабирования.
+   * @return false если набор вершин пуст.
+   */
+  static bool normalizationFor(const std::vector<Vertex>& points,
+                               Vertex& center, float& scaleFactor) {
+    // 1. Находим границы модели
+    return normalizationForBounds(
+        VertexKernels::bounds(coords(points), points.size()), center,
+        scaleFactor);
+  }
+
+  /**
+   * @brief Параметры нормализации по уже известному ограничивающему боксу.
+   * @return false если бокс пуст.
+   */
+  static bool normalizationForBounds(const BoundingBox& box, Vertex& center,
+                                     float& scaleFactor) {
+    if (box.empty()) return false;
 
-    // Обновляем оригинальные вершины
-    currentPosition = vertices;
+    // 2. Вычисляем размеры модели
+    float sizeX = box.max[0] - box.min[0];
+    float sizeY = box.max[1] - box.min[1];
+    float sizeZ = box.max[2] - box.min[2];
+    float maxSize = std::max({sizeX, sizeY, sizeZ});
+
+    // 3. Вычисляем центр
+    center.x = (box.min[0] + box.max[0]) / 2.0f;
+    center.y = (box.min[1] + box.max[1]) / 2.0f;
+    center.z = (box.min[2] + box.max[2]) / 2.0f;
+
+    scaleFactor = kNormalizedSize / maxSize;
+    return true;
   }
 
   /**
    * @brief Масштабирует модель в заданный размер и центрирует.
    */
   void normalizeModel() {
-    if (!(vertices.empty())) {
-      // 1. Находим границы модели
-      float minX = std::numeric_limits<float>::max();
-      float minY = std::numeric_limits<float>::max();
-      float minZ = std::numeric_limits<float>::max();
-      float maxX = std::numeric_limits<float>::lowest();
-      float maxY = std::numeric_limits<float>::lowest();
-      float maxZ = std::numeric_limits<float>::lowest();
-
-      for (const auto& vertex : vertices) {
-        minX = std::min(minX, vertex.x);
-        minY = std::min(minY, vertex.y);
-        minZ = std::min(minZ, vertex.z);
-        maxX = std::max(maxX, vertex.x);
-        maxY = std::max(maxY, vertex.y);
-        maxZ = std::max(maxZ, vertex.z);
-      }
-
-      // 2. Вычисляем размеры модели
-      float sizeX = maxX - minX;
-      float sizeY = maxY - minY;
-      float sizeZ = maxZ - minZ;
-      float maxSize = std::max({sizeX, sizeY, sizeZ});
+    // Бокс и центр масс считаются одним параллельным проходом; после
+    // нормализации они пересчитываются аналитически, без второго прохода
+    rotationSinceShift = PreciseRotation();
+    refreshStatistics();
+    Vertex center;
+    float scaleFactor;
+    if (normalizationForBounds(statisticsBounds, center, scaleFactor)) {
+      // 4. Центрируем и масштабируем за один проход
+      AffineTransform normalize =
+          AffineTransform::scaling(scaleFactor) *
+          AffineTransform::translation(-center.x, -center.y, -center.z);
+      VertexKernels::transform(normalize, coords(vertices), coords(vertices),
+                               vertices.size());
+      statisticsBounds = statisticsBounds.transformed(normalize);
+      normalize.apply(positionCenter.x, positionCenter.y, positionCenter.z);
+
+      // установка начальной позиции в центра координат
+      previousShift = {0, 0, 0};
+      resetTransform();
+    }
+  }
 
-      // 3. Вычисляем центр
-      Vertex center;
-      center.x = (minX + maxX) / 2.0f;
-      center.y = (minY + maxY) / 2.0f;
-      center.z = (minZ + maxZ) / 2.0f;
+  /**
+   * @brief Делает текущие вершины начальной позицией модели (без смещения).
+   */
+  void resetPosition() {
+    rotationSinceShift = PreciseRotation();
+    refreshStatistics();
+    previousShift = {0, 0, 0};
+    resetTransform();
+  }
 
-      // 4. Масштабируем и центрируем
-      float targetSize = 12.0f;  // Желаемый размер (можно регулировать)
-      float scaleFactor = targetSize / maxSize;
+  /**
+   * @brief Сбрасывает отложенное преобразование transform для текущих
+   * вершин.
+   */
+  void resetTransform() {
+    Vertex center = calculateCenter();
+    transform.reset(center.x, center.y, center.z);
+  }
 
-      for (auto& vertex : vertices) {
-        // Центрируем
-        vertex -= center;
+  /**
+   * @brief Ограничивающий бокс вершин в текущей позиции.
+   *
+   * Точный бокс вычисляется при загрузке (normalizeModel(), resetPosition())
+   * вместе с центром масс; повороты и сдвиги переносят его аналитически,
+   * поэтому запрос стоит O(1). После поворотов бокс строится по углам
+   * повёрнутого бокса и может быть немного шире точного.
+   */
+  BoundingBox bounds() const {
+    if (!statisticsValid) refreshStatistics();
+    return statisticsBounds.transformed(rotationAboutCenter() * shiftAnchor);
+  }
 
-        // Масштабируем
-        vertex *= scaleFactor;
-      }
+  /**
+   * @brief Вершины с применённым отложенным преобразованием.
+   *
+   * Сами вершины модели не меняются; копия нужна только для экспорта и
+   * вычислений на CPU.
+   */
+  std::vector<Vertex> bakedVertices() const {
+    return bakedVertices(transform.matrix());
+  }
 
-      currentPosition =
-          vertices;  // установка начальной позиции в центра координат
-      previousShift = {0, 0, 0};
-    }
+  /**
+   * @brief Вершины с применённым преобразованием matrix (например,
+   * ModelTransform, хранящимся вне модели).
+   */
+  std::vector<Vertex> bakedVertices(const AffineTransform& matrix) const {
+    std::vector<Vertex> baked(vertices.size());
+    VertexKernels::transform(matrix, coords(vertices), coords(baked),
+                             vertices.size());
+    return baked;
   }
 
   /**
    * @brief Добавить вершину в модель.
    */
-  void addVertex(const Vertex& vertex) { vertices.push_back(vertex); }
+  void addVertex(const Vertex& vertex) {
+    vertices.push_back(vertex);
+    statisticsValid = false;
+    // Новая вершина не повёрнута: текущая позиция становится начальной
+    rotationSinceShift = PreciseRotation();
+  }
 
   /**
    * @brief Получить все вершины модели.
@@ -293,18 +620,26 @@ class Model3D {
    * @throw std::out_of_range если индекс вершины недопустим.
    */
   void addPolygon(const Polygon& polygon) {
-    for (int index : polygon.vertexIndices) {
+    addPolygon(std::span<const int>(polygon.vertexIndices));
+  }
+
+  /**
+   * @brief Добавить полигон по индексам вершин без создания Polygon.
+   * @throw std::out_of_range если индекс вершины недопустим.
+   */
+  void addPolygon(std::span<const int> vertexIndices) {
+    for (int index : vertexIndices) {
       if (index < 0 || index >= static_cast<int>(vertices.size())) {
         throw std::out_of_range("Invalid vertex index in polygon");
       }
     }
-    polygons.push_back(polygon);
+    polygons.push_back(vertexIndices);
   }
 
   /**
    * @brief Получить все полигоны модели.
    */
-  const std::vector<Polygon>& getPolygons() const { return polygons; }
+  const PolygonList& getPolygons() const { return polygons; }
 
   /**
    * @brief Получить вершину по индексу.
@@ -321,7 +656,7 @@ class Model3D {
    * @brief Получить полигон по индексу.
    * @throw std::out_of_range если индекс недопустим.
    */
-  const Polygon& getPolygon(int index) const {
+  PolygonView getPolygon(int index) const {
     if (index < 0 || index >= static_cast<int>(polygons.size())) {
       throw std::out_of_range("Invalid polygon index");
     }
@@ -329,18 +664,14 @@ class Model3D {
   }
 
   /**
-   * @brief Вычисляет центр модели.
+   * @brief Вычисляет центр модели (центр масс вершин).
+   *
+   * Значение кэшируется вместе с bounds() и обновляется при поворотах и
+   * сдвигах без прохода по вершинам.
    */
   Vertex calculateCenter() const {
-    Vertex center = {0, 0, 0};
-    for (const auto& vertex : vertices) {
-      center += vertex;
-    }
-
-    size_t count = vertices.size();
-    center /= count;
-
-    return center;
+    if (!statisticsValid) refreshStatistics();
+    return positionCenter;
   }
 
   /**
@@ -350,58 +681,24 @@ class Model3D {
    * @param angleZ Угол поворота по Z
    */
   void rotateModel(float angleX, float angleY, float angleZ) {
-    // Вычисляем центр модели
-    vertices = currentPosition;  // Начальная позиция поворота равна точка
-                                 // перемещения модели
-    Vertex center = calculateCenter();
-
-    // Преобразование углов из градусов в радианы
-    float radX = angleX * M_PI / 180.0f;
-    float radY = angleY * M_PI / 180.0f;
-    float radZ = angleZ * M_PI / 180.0f;
-
-    // Вычисление значений sin и cos для каждого угла
-    float cosX = std::cos(radX), sinX = std::sin(radX);
-    float cosY = std::cos(radY), sinY = std::sin(radY);
-    float cosZ = std::cos(radZ), sinZ = std::sin(radZ);
-
-    // Перемещаем модель так, чтобы её центр совпал с началом координат
-    for (auto& vertex : vertices) {
-      vertex -= center;
-    }
+    if (vertices.empty()) return;
 
-    // Применяем поворот к каждой вершине
-    for (auto& vertex : vertices) {
-      float x = vertex.x, y = vertex.y, z = vertex.z;
-
-      // Поворот вокруг оси X
-      float newY = y * cosX - z * sinX;
-      float newZ = y * sinX + z * cosX;
-      y = newY;
-      z = newZ;
-
-      // Поворот вокруг оси Y
-      float newX = x * cosY + z * sinY;
-      newZ = -x * sinY + z * cosY;
-      x = newX;
-      z = newZ;
-
-      // Поворот вокруг оси Z
-      newX = x * cosZ - y * sinZ;
-      newY = x * sinZ + y * cosZ;
-      x = newX;
-      y = newY;
-
-      // Обновляем координаты вершины
-      vertex.x = x;
-      vertex.y = y;
-      vertex.z = z;
-    }
+    // Поворот идёт вокруг центра масс, поэтому центр не меняется при
+    // поворотах, а при сдвиге смещается вместе с моделью
+    Vertex center = calculateCenter();
 
-    // Возвращаем модель в исходное положение
-    for (auto& vertex : vertices) {
-      vertex += center;
-    }
+    // Углы отсчитываются от позиции после последнего сдвига. Копии этой
+    // позиции нет: шаг от прежнего поворота к новому строится в double из
+    // углов (обратный поворот — транспонированная матрица) и применяется
+    // одним проходом, а вершины округляются до float один раз за шаг.
+    // Поэтому при перетаскивании ползунка не накапливается ни искажение
+    // матрицы, ни масштаб — только шум округления вершин
+    PreciseRotation rotation =
+        PreciseRotation::fromAngles(angleX, angleY, angleZ);
+    VertexKernels::rotate(rotation * rotationSinceShift.inverse(), center.x,
+                          center.y, center.z, coords(vertices),
+                          vertices.size());
+    rotationSinceShift = rotation;
   }
 
   /**
@@ -413,13 +710,18 @@ class Model3D {
   void shiftModel(float shiftX, float shiftY, float shiftZ) {
     Vertex tempShift = {shiftX, shiftY, shiftZ};
     Vertex currentShift = tempShift - previousShift;
-    //  Вычисляем центр модели
-    for (auto& vertex : vertices) {
-      vertex += currentShift;
-    }
+    AffineTransform shift = AffineTransform::translation(
+        currentShift.x, currentShift.y, currentShift.z);
+    VertexKernels::transform(shift, coords(vertices), coords(vertices),
+                             vertices.size());
     previousShift = tempShift;
-    currentPosition =
-        vertices;  // устанавливаем точку для указаная положения модели
+    // Текущее положение становится начальным для следующих поворотов;
+    // устаревший бокс пересчитается при запросе уже от новой позиции
+    if (statisticsValid) {
+      shiftAnchor = shift * rotationAboutCenter() * shiftAnchor;
+      positionCenter += currentShift;
+    }
+    rotationSinceShift = PreciseRotation();
   }
 
   /**
@@ -427,8 +729,8 @@ class Model3D {
    */
   void clear() {
     vertices.clear();
-    currentPosition.clear();
     polygons.clear();
+    resetPosition();
   }
 
   /**
@@ -437,10 +739,54 @@ class Model3D {
   void printModelInfo() const {
     std::cout << "Model contains " << vertices.size() << " vertices and "
               << polygons.size() << " polygons.\n";
-    for (auto polygon : polygons) {
+    for (PolygonView polygon : polygons) {
       polygon.printP();
     }
   }
+
+ private:
+  PreciseRotation rotationSinceShift;  ///< Поворот после последнего сдвига
+  mutable BoundingBox statisticsBounds;  ///< Точный бокс при подсчёте
+  mutable AffineTransform
+      shiftAnchor;  ///< Позиция подсчёта бокса -> позиция после сдвига
+  mutable Vertex positionCenter;        ///< Центр масс вершин (кэш)
+  mutable bool statisticsValid = false;  ///< Актуальны ли бокс и центр
+
+  /**
+   * @brief Текущий поворот после сдвига вокруг центра масс.
+   */
+  AffineTransform rotationAboutCenter() const {
+    return rotationSinceShift.about(positionCenter.x, positionCenter.y,
+                                    positionCenter.z);
+  }
+
+  /**
+   * @brief Вычисляет бокс и центр масс вершин одним параллельным проходом.
+   */
+  void refreshStatistics() const {
+    VertexStatistics stats =
+        VertexKernels::statistics(coords(vertices), vertices.size());
+    statisticsBounds = stats.box;
+    double count = static_cast<double>(std::max<size_t>(1, vertices.size()));
+    positionCenter = Vertex(stats.sum[0] / count, stats.sum[1] / count,
+                            stats.sum[2] / count);
+    // Бокс подсчитан в повёрнутой позиции; позиция после сдвига получается
+    // из неё обратным поворотом вокруг центра масс
+    shiftAnchor = rotationSinceShift.inverse().about(
+        positionCenter.x, positionCenter.y, positionCenter.z);
+    statisticsValid = true;
+  }
+
+  /**
+   * @brief Координаты вершин как массив x, y, z подряд для VertexKernels.
+   */
+  static const float* coords(const std::vector<Vertex>& points) {
+    return reinterpret_cast<const float*>(points.data());
+  }
+
+  static float* coords(std::vector<Vertex>& points) {
+    return reinterpret_cast<float*>(points.data());
+  }
 };  // class Model3D
 
 }  // namespace s21
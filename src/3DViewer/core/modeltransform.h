@@ -0,0 +1,79 @@
+/**
+ * @file modeltransform.h
+ * @brief Класс ModelTransform — отложенное преобразование модели,
+ * накапливаемое без изменения вершин.
+ */
+
+#ifndef MODEL_TRANSFORM_H
+#define MODEL_TRANSFORM_H
+
+#include "affinetransform.h"
+
+namespace s21 {
+
+/**
+ * @class ModelTransform
+ * @brief Поворот и сдвиг модели в виде одной матрицы вместо перезаписи
+ * массива вершин.
+ *
+ * Повторяет поведение Model3D::rotateModel() и Model3D::shiftModel():
+ * поворот задаётся абсолютными углами относительно позиции, в которой
+ * модель оказалась после последнего сдвига, и выполняется вокруг её центра
+ * масс; сдвиг задаётся абсолютным вектором и закрепляет текущий поворот.
+ * Центр масс аффинно преобразованных вершин равен образу исходного центра,
+ * поэтому каждая операция стоит O(1) независимо от размера модели.
+ */
+class ModelTransform {
+ public:
+  /**
+   * @brief Сбрасывает преобразование в тождественное.
+   * @param cx, cy, cz Центр масс исходных вершин.
+   */
+  void reset(float cx, float cy, float cz) {
+    *this = ModelTransform();
+    center[0] = cx;
+    center[1] = cy;
+    center[2] = cz;
+  }
+
+  /**
+   * @brief Поворот на заданные углы (в градусах) от позиции последнего
+   * сдвига, как в Model3D::rotateModel().
+   */
+  void rotate(float angleX, float angleY, float angleZ) {
+    float cx = center[0], cy = center[1], cz = center[2];
+    anchor.apply(cx, cy, cz);
+    current = AffineTransform::rotation(angleX, angleY, angleZ)
+                  .about(cx, cy, cz) *
+              anchor;
+  }
+
+  /**
+   * @brief Сдвиг на абсолютный вектор, как в Model3D::shiftModel().
+   */
+  void shift(float shiftX, float shiftY, float shiftZ) {
+    current = AffineTransform::translation(shiftX - previousShift[0],
+                                           shiftY - previousShift[1],
+                                           shiftZ - previousShift[2]) *
+              current;
+    anchor = current;
+    previousShift[0] = shiftX;
+    previousShift[1] = shiftY;
+    previousShift[2] = shiftZ;
+  }
+
+  /**
+   * @brief Итоговое преобразование исходных вершин.
+   */
+  const AffineTransform& matrix() const { return current; }
+
+ private:
+  AffineTransform current;  ///< Преобразование отображаемой позиции
+  AffineTransform anchor;  ///< Позиция после последнего сдвига
+  float center[3] = {0, 0, 0};         ///< Центр масс исходных вершин
+  float previousShift[3] = {0, 0, 0};  ///< Последний заданный сдвиг
+};  // class ModelTransform
+
+}  // namespace s21
+
+#endif  // MODEL_TRANSFORM_H
@@ -0,0 +1,127 @@
+/**
+ * @file quantizedpositions.h
+ * @brief Класс PositionQuantizer — компактное хранение координат вершин
+ * 16-битными целыми относительно ограничивающего бокса.
+ */
+
+#ifndef QUANTIZED_POSITIONS_H
+#define QUANTIZED_POSITIONS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "affinetransform.h"
+#include "threadpool.h"
+#include "vertexkernels.h"
+
+namespace s21 {
+
+/**
+ * @brief Координаты вершины в 16-битных нормализованных целых: 0 — минимум
+ * бокса по оси, 65535 — максимум.
+ */
+struct QuantizedPosition {
+  uint16_t x = 0;
+  uint16_t y = 0;
+  uint16_t z = 0;
+};
+
+static_assert(sizeof(QuantizedPosition) == 3 * sizeof(uint16_t),
+              "QuantizedPosition must be packed as three uint16");
+
+/**
+ * @class PositionQuantizer
+ * @brief Переводит координаты в QuantizedPosition и обратно.
+ *
+ * Шаг сетки по каждой оси равен размеру бокса, делённому на 65535, поэтому
+ * ошибка не превышает половины шага, то есть размера бокса / 131070 (для
+ * нормализованной модели размером Model3D::kNormalizedSize = 12 — около
+ * 9.2e-5). Обратное преобразование — аффинное (масштаб по осям и перенос
+ * в угол бокса), поэтому распаковка выполняется тем же ядром
+ * VertexKernels::transform(), что и остальные преобразования вершин.
+ */
+class PositionQuantizer {
+ public:
+  static constexpr float kLevels = 65535.0f;  ///< Наибольшее значение
+
+  /**
+   * @brief Сетка по боксу вершин; для пустого бокса — вырожденная сетка в
+   * начале координат.
+   */
+  explicit PositionQuantizer(const BoundingBox& box) {
+    if (box.empty()) return;
+    for (int axis = 0; axis < 3; ++axis) {
+      origin_[axis] = box.min[axis];
+      step_[axis] = (box.max[axis] - box.min[axis]) / kLevels;
+    }
+  }
+
+  /**
+   * @brief Шаг сетки по оси.
+   */
+  float step(int axis) const { return step_[axis]; }
+
+  /**
+   * @brief Упаковывает одну точку.
+   */
+  QuantizedPosition encode(float x, float y, float z) const {
+    return QuantizedPosition{level(x, 0), level(y, 1), level(z, 2)};
+  }
+
+  /**
+   * @brief Упаковывает count вершин, записанных подряд (x, y, z).
+   */
+  void encode(const float* xyz, size_t count, QuantizedPosition* out) const {
+    ThreadPool::instance().parallelFor(
+        count, VertexKernels::kParallelGrain, [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            const float* p = xyz + 3 * i;
+            out[i] = encode(p[0], p[1], p[2]);
+          }
+        });
+  }
+
+  /**
+   * @brief Преобразование целых координат сетки в исходные.
+   */
+  AffineTransform dequantization() const {
+    AffineTransform t;
+    for (int axis = 0; axis < 3; ++axis) {
+      t.m[axis][axis] = step_[axis];
+      t.m[axis][3] = origin_[axis];
+    }
+    return t;
+  }
+
+  /**
+   * @brief Распаковывает count вершин в массив (x, y, z).
+   */
+  void decode(const QuantizedPosition* in, size_t count, float* xyz) const {
+    ThreadPool::instance().parallelFor(
+        count, VertexKernels::kParallelGrain, [&](size_t begin, size_t end) {
+          float* out = xyz + 3 * begin;
+          for (size_t i = begin; i < end; ++i, out += 3) {
+            out[0] = in[i].x;
+            out[1] = in[i].y;
+            out[2] = in[i].z;
+          }
+        });
+    VertexKernels::transform(dequantization(), xyz, xyz, count);
+  }
+
+ private:
+  uint16_t level(float value, int axis) const {
+    if (step_[axis] <= 0.0f) return 0;
+    float scaled = std::round((value - origin_[axis]) / step_[axis]);
+    return static_cast<uint16_t>(std::clamp(scaled, 0.0f, kLevels));
+  }
+
+  float origin_[3] = {0, 0, 0};  ///< Угол бокса (значение 0)
+  float step_[3] = {0, 0, 0};    ///< Шаг сетки по осям
+};  // class PositionQuantizer
+
+}  // namespace s21
+
+#endif  // QUANTIZED_POSITIONS_H
@@ -0,0 +1,54 @@
+/**
+ * @file simd.h
+ * @brief Определение доступных наборов SIMD-инструкций и выбор реализации
+ * во время выполнения.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#include <immintrin.h>
+#define S21_HAS_SSE2 1
+#else
+#define S21_HAS_SSE2 0
+#endif
+
+#if S21_HAS_SSE2
+#define S21_HAS_AVX2 1
+#define S21_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define S21_HAS_AVX2 0
+#define S21_TARGET_AVX2
+#endif
+
+namespace s21 {
+
+/**
+ * @brief Набор инструкций, которым пользуются векторные ядра.
+ */
+enum class SimdIsa { kScalar, kSse2, kAvx2 };
+
+/**
+ * @brief Определяет лучший набор инструкций, доступный процессору.
+ *
+ * SSE2 входит в базовый набор x86-64 и проверяется при компиляции, AVX2 —
+ * во время выполнения, поэтому сборка без -mavx2 всё равно использует AVX2
+ * на поддерживающих его процессорах.
+ */
+inline SimdIsa detectSimdIsa() {
+#if S21_HAS_AVX2
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdIsa::kAvx2;
+  }
+#endif
+#if S21_HAS_SSE2
+  return SimdIsa::kSse2;
+#else
+  return SimdIsa::kScalar;
+#endif
+}
+
+}  // namespace s21
+
+#endif  // SIMD_H
@@ -0,0 +1,488 @@
+/**
+ * @file threadpool.h
+ * @brief Класс ThreadPool — общий планировщик задач приложения: очереди
+ * рабочих потоков с перехватом задач, приоритеты и отмена.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+/**
+ * @brief Приоритет задачи планировщика.
+ *
+ * Свободный поток сначала берёт интерактивные задачи (отклик на действия
+ * пользователя: преобразования, упаковка буферов), затем фоновые
+ * (загрузка моделей, обработка изображений).
+ */
+enum class TaskPriority { kInteractive, kBackground };
+
+/**
+ * @class CancellationToken
+ * @brief Флаг кооперативной отмены, общий для копий токена.
+ *
+ * Задача, отменённая до запуска, не выполняется; выполняющаяся задача
+ * сама проверяет cancelled() и завершается досрочно.
+ */
+class CancellationToken {
+ public:
+  CancellationToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+  /**
+   * @brief Запрашивает отмену всех задач с этим токеном.
+   */
+  void cancel() const { flag_->store(true, std::memory_order_relaxed); }
+
+  /**
+   * @brief Запрошена ли отмена.
+   */
+  bool cancelled() const { return flag_->load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Сам флаг, например для ParseControl::cancelled. Действителен,
+   * пока существует хотя бы одна копия токена.
+   */
+  const std::atomic<bool>* flag() const { return flag_.get(); }
+
+ private:
+  std::shared_ptr<std::atomic<bool>> flag_;
+};  // class CancellationToken
+
+class ThreadPool;
+
+/**
+ * @class TaskHandle
+ * @brief Результат ThreadPool::submit(): ожидание и состояние задачи.
+ */
+class TaskHandle {
+ public:
+  TaskHandle() = default;
+
+  /**
+   * @brief Связан ли описатель с задачей.
+   */
+  bool valid() const { return state_ != nullptr; }
+
+  /**
+   * @brief Задача выполнена или пропущена из-за отмены.
+   */
+  bool done() const {
+    if (!state_) return true;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->done;
+  }
+
+  /**
+   * @brief Задача не запускалась, потому что была отменена раньше.
+   */
+  bool cancelled() const {
+    if (!state_) return false;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->skipped;
+  }
+
+  /**
+   * @brief Ждёт завершения задачи и передаёт её исключение.
+   *
+   * Ещё не начатая задача выполняется в ожидающем потоке, поэтому ожидание
+   * не зависит от занятости пула. В рабочем потоке пула ожидание не
+   * блокирует поток: пока задача не завершена, он выполняет другие задачи
+   * из очередей.
+   */
+  void wait() const;
+
+ private:
+  friend class ThreadPool;
+
+  /**
+   * @brief Состояние задачи, общее для описателей и исполнителя.
+   */
+  struct State {
+    std::function<void()> task;
+    CancellationToken token;
+    std::atomic<bool> started{false};  ///< Задачу взял какой-либо поток
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;         ///< Задача завершена (под mutex)
+    bool skipped = false;      ///< Задача отменена до запуска (под mutex)
+    std::exception_ptr error;  ///< Исключение задачи (под mutex)
+
+    /**
+     * @brief Выполняет задачу, если её ещё не взял другой поток.
+     */
+    void run() {
+      if (started.exchange(true)) return;
+      bool wasSkipped = token.cancelled();
+      std::exception_ptr failure;
+      if (!wasSkipped) {
+        try {
+          task();
+        } catch (...) {
+          failure = std::current_exception();
+        }
+      }
+      task = nullptr;  // Освобождаем захваченные задачей ресурсы
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        skipped = wasSkipped;
+        error = failure;
+      }
+      finished.notify_all();
+    }
+  };
+
+  TaskHandle(ThreadPool* pool, std::shared_ptr<State> state)
+      : pool_(pool), state_(std::move(state)) {}
+
+  ThreadPool* pool_ = nullptr;
+  std::shared_ptr<State> state_;
+};  // class TaskHandle
+
+/**
+ * @class ThreadPool
+ * @brief Планировщик задач с перехватом работы (work stealing) и
+ * параллельным циклом parallelFor().
+ *
+ * Потоки создаются один раз и переиспользуются всем приложением: разбор
+ * файлов, ядра над вершинами, упаковка буферов и обработка изображений
+ * ставят задачи сюда, а не заводят собственные потоки.
+ *
+ * У каждого рабочего потока своя очередь: задачи, поставленные из
+ * рабочего потока, попадают в его очередь и берутся им с конца (последняя
+ * поставленная — первой, пока её данные в кэше). Задачи из остальных
+ * потоков попадают в общую очередь. Свободный поток берёт задачу из своей
+ * очереди, затем из общей, затем перехватывает самую старую задачу из
+ * очереди другого потока; интерактивные задачи всегда раньше фоновых.
+ *
+ * Вызывающий поток тоже выполняет части parallelFor(), а ожидающий
+ * рабочий поток выполняет чужие задачи, поэтому вложенные циклы и
+ * ожидание задач из задач не блокируют пул.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Создаёт пул.
+   * @param threadCount Число потоков parallelFor() вместе с вызывающим;
+   * 0 — по числу ядер процессора. Для задач submit() всегда создаётся хотя
+   * бы один рабочий поток.
+   */
+  explicit ThreadPool(unsigned threadCount = 0) {
+    if (threadCount == 0) {
+      threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount_ = threadCount;
+    unsigned workerCount = std::max(1u, threadCount - 1);
+    for (unsigned i = 0; i < workerCount; ++i) {
+      queues_.push_back(std::make_unique<Queue>());
+    }
+    workers_.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+      workers_.emplace_back([this, i]() { workerLoop(i); });
+    }
+  }
+
+  /**
+   * @brief Деструктор. Дожидается завершения уже поставленных задач.
+   */
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Общий пул приложения.
+   */
+  static ThreadPool& instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  /**
+   * @brief Число потоков, выполняющих parallelFor(), вместе с вызывающим.
+   */
+  unsigned concurrency() const { return threadCount_; }
+
+  /**
+   * @brief Число частей, на которые parallelFor() делит count элементов.
+   *
+   * Часть не меньше grain элементов, поэтому маленькие массивы (например,
+   * модель из десятка вершин) обрабатываются в вызывающем потоке без
+   * обращения к пулу.
+   *
+   * @param maxThreads Ограничение числа потоков; 0 — без ограничения.
+   */
+  size_t partsFor(size_t count, size_t grain, unsigned maxThreads = 0) const {
+    size_t threads = concurrency();
+    if (maxThreads != 0) threads = std::min<size_t>(threads, maxThreads);
+    return std::max<size_t>(
+        1, std::min(threads, count / std::max<size_t>(1, grain)));
+  }
+
+  /**
+   * @brief Ставит задачу в очередь.
+   *
+   * Задача, отменённая через token до запуска, не выполняется
+   * (TaskHandle::cancelled()); уже запущенная задача проверяет token сама.
+   * Исключение задачи передаётся из TaskHandle::wait().
+   *
+   * @param task Копируемый вызываемый объект без аргументов.
+   * @param priority Приоритет задачи.
+   * @param token Токен отмены.
+   */
+  template <typename Task>
+  TaskHandle submit(Task&& task,
+                    TaskPriority priority = TaskPriority::kInteractive,
+                    CancellationToken token = CancellationToken()) {
+    auto state = std::make_shared<TaskHandle::State>();
+    state->task = std::forward<Task>(task);
+    state->token = std::move(token);
+    push([state]() { state->run(); }, priority);
+    return TaskHandle(this, std::move(state));
+  }
+
+  /**
+   * @brief Выполняет body(begin, end) для частей диапазона [0, count).
+   *
+   * Диапазон делится на partsFor() частей; части разбирают вызывающий
+   * поток и свободные рабочие потоки. Части получают приоритет задачи, из
+   * которой вызван цикл (интерактивный вне пула). Возвращается после
+   * выполнения всех частей; первое исключение из body передаётся
+   * вызывающему.
+   *
+   * @param grain Минимальный размер части (порог распараллеливания).
+   * @param maxThreads Ограничение числа потоков; 0 — без ограничения.
+   */
+  template <typename Body>
+  void parallelFor(size_t count, size_t grain, Body&& body,
+                   unsigned maxThreads = 0) {
+    size_t parts = partsFor(count, grain, maxThreads);
+    if (parts <= 1) {
+      if (count > 0) body(size_t(0), count);
+      return;
+    }
+
+    auto loop = std::make_shared<Loop>();
+    loop->remaining = parts;
+    loop->run = [count, parts, &body](size_t part) {
+      body(count * part / parts, count * (part + 1) / parts);
+    };
+    loop->parts = parts;
+
+    TaskPriority priority = context().priority;
+    for (size_t i = 1; i < parts; ++i) {
+      push([loop]() { loop->work(); }, priority);
+    }
+
+    loop->work();
+    loop->wait();
+    if (loop->error) std::rethrow_exception(loop->error);
+  }
+
+ private:
+  friend class TaskHandle;
+
+  static constexpr size_t kPriorityCount = 2;
+  static constexpr std::chrono::milliseconds kHelpInterval{
+      1};  ///< Период проверки очередей ожидающим рабочим потоком
+
+  /**
+   * @brief Состояние одного вызова parallelFor(), общее для потоков.
+   */
+  struct Loop {
+    std::function<void(size_t)> run;
+    size_t parts = 0;
+    std::atomic<size_t> next{0};  ///< Следующая невзятая часть
+    size_t remaining = 0;         ///< Невыполненные части (под mutex)
+    std::exception_ptr error;     ///< Первое исключение (под mutex)
+    std::mutex mutex;
+    std::condition_variable done;
+
+    /**
+     * @brief Выполняет части, пока они не закончатся.
+     */
+    void work() {
+      for (size_t part = next++; part < parts; part = next++) {
+        std::exception_ptr failure;
+        try {
+          run(part);
+        } catch (...) {
+          failure = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failure && !error) error = failure;
+        if (--remaining == 0) done.notify_all();
+      }
+    }
+
+    /**
+     * @brief Ждёт выполнения всех частей.
+     */
+    void wait() {
+      std::unique_lock<std::mutex> lock(mutex);
+      done.wait(lock, [this]() { return remaining == 0; });
+    }
+  };
+
+  /**
+   * @brief Очередь задач по приоритетам (своя у каждого рабочего потока и
+   * одна общая).
+   */
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks[kPriorityCount];
+  };
+
+  /**
+   * @brief Сведения о текущем потоке.
+   */
+  struct Context {
+    ThreadPool* pool = nullptr;  ///< Пул, которому принадлежит поток
+    size_t index = 0;            ///< Номер рабочего потока в пуле
+    TaskPriority priority = TaskPriority::kInteractive;  ///< Текущая задача
+  };
+
+  static Context& context() {
+    static thread_local Context current;
+    return current;
+  }
+
+  /**
+   * @brief Ставит задачу в очередь текущего рабочего потока или в общую.
+   */
+  void push(std::function<void()> task, TaskPriority priority) {
+    Context& current = context();
+    Queue& queue = current.pool == this ? *queues_[current.index] : shared_;
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++pending_;
+    }
+    wake_.notify_one();
+  }
+
+  /**
+   * @brief Берёт задачу из очереди с начала или с конца.
+   */
+  static std::function<void()> take(Queue& queue, size_t priority,
+                                    bool newest) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    auto& tasks = queue.tasks[priority];
+    if (tasks.empty()) return nullptr;
+    std::function<void()> task;
+    if (newest) {
+      task = std::move(tasks.back());
+      tasks.pop_back();
+    } else {
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    return task;
+  }
+
+  /**
+   * @brief Находит и выполняет одну задачу.
+   * @param self Номер рабочего потока или queues_.size() вне пула.
+   * @return false если очереди пусты.
+   */
+  bool runOne(size_t self) {
+    std::function<void()> task;
+    size_t priority = 0;
+    for (; priority < kPriorityCount && !task; ++priority) {
+      if (self < queues_.size()) task = take(*queues_[self], priority, true);
+      if (!task) task = take(shared_, priority, false);
+      for (size_t i = 1; !task && i <= queues_.size(); ++i) {
+        size_t victim = (self + i) % (queues_.size() + 1);
+        if (victim < queues_.size()) {
+          task = take(*queues_[victim], priority, false);
+        }
+      }
+    }
+    if (!task) return false;
+    --pending_;
+
+    Context& current = context();
+    TaskPriority saved = current.priority;
+    current.priority = static_cast<TaskPriority>(priority - 1);
+    task();
+    current.priority = saved;
+    return true;
+  }
+
+  void workerLoop(size_t index) {
+    context() = Context{this, index, TaskPriority::kInteractive};
+    for (;;) {
+      if (runOne(index)) continue;
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this]() { return stopping_ || pending_ > 0; });
+      if (stopping_ && pending_ <= 0) return;
+    }
+  }
+
+  /**
+   * @brief Ожидание задачи для TaskHandle::wait().
+   */
+  void waitFor(TaskHandle::State& state) {
+    Context& current = context();
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.done) {
+      if (current.pool == this) {
+        lock.unlock();
+        bool ran = runOne(current.index);
+        lock.lock();
+        if (ran || state.done) continue;
+        state.finished.wait_for(lock, kHelpInterval);
+      } else {
+        state.finished.wait(lock);
+      }
+    }
+  }
+
+  unsigned threadCount_ = 1;  ///< Потоки parallelFor() с вызывающим
+  std::vector<std::unique_ptr<Queue>> queues_;  ///< Очереди рабочих потоков
+  Queue shared_;                      ///< Задачи из потоков вне пула
+  std::vector<std::thread> workers_;  ///< Рабочие потоки
+  /// Поставленные и ещё не взятые задачи; увеличивается под mutex_ и может
+  /// кратковременно стать отрицательным, если задачу взяли раньше
+  std::atomic<std::ptrdiff_t> pending_{0};
+  std::mutex mutex_;              ///< Защита stopping_ и ожидания задач
+  std::condition_variable wake_;  ///< Сигнал о новых задачах
+  bool stopping_ = false;         ///< Пул завершает работу
+};  // class ThreadPool
+
+inline void TaskHandle::wait() const {
+  if (!state_) return;
+  state_->run();
+  pool_->waitFor(*state_);
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  if (state_->error) std::rethrow_exception(state_->error);
+}
+
+}  // namespace s21
+
+#endif  // THREAD_POOL_H
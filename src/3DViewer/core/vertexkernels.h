@@ -0,0 +1,761 @@
+/**
+ * @file vertexkernels.h
+ * @brief Хранилище вершин в виде структуры массивов (VertexSoA) и векторные
+ * ядра преобразования и поиска границ вершин.
+ */
+
+#ifndef VERTEX_KERNELS_H
+#define VERTEX_KERNELS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "affinetransform.h"
+#include "simd.h"
+#include "threadpool.h"
+
+namespace s21 {
+
+/**
+ * @brief Ограничивающий бокс набора вершин.
+ *
+ * Для пустого набора min равен +max(float), max равен lowest(float).
+ */
+struct BoundingBox {
+  float min[3] = {std::numeric_limits<float>::max(),
+                  std::numeric_limits<float>::max(),
+                  std::numeric_limits<float>::max()};
+  float max[3] = {std::numeric_limits<float>::lowest(),
+                  std::numeric_limits<float>::lowest(),
+                  std::numeric_limits<float>::lowest()};
+
+  /**
+   * @brief Проверка, что бокс не содержит ни одной точки.
+   */
+  bool empty() const { return min[0] > max[0]; }
+
+  /**
+   * @brief Расширяет бокс до точки (x, y, z).
+   */
+  void include(float x, float y, float z) {
+    const float point[3] = {x, y, z};
+    for (int axis = 0; axis < 3; ++axis) {
+      min[axis] = std::min(min[axis], point[axis]);
+      max[axis] = std::max(max[axis], point[axis]);
+    }
+  }
+
+  /**
+   * @brief Расширяет бокс до другого бокса.
+   */
+  void merge(const BoundingBox& other) {
+    for (int axis = 0; axis < 3; ++axis) {
+      min[axis] = std::min(min[axis], other.min[axis]);
+      max[axis] = std::max(max[axis], other.max[axis]);
+    }
+  }
+
+  /**
+   * @brief Бокс, содержащий образ этого бокса при преобразовании t.
+   *
+   * Строится по восьми преобразованным углам, поэтому при повороте он
+   * может быть шире точного бокса вершин, но всегда их содержит.
+   */
+  BoundingBox transformed(const AffineTransform& t) const {
+    BoundingBox result;
+    if (empty()) return result;
+    for (int corner = 0; corner < 8; ++corner) {
+      float x = corner & 1 ? max[0] : min[0];
+      float y = corner & 2 ? max[1] : min[1];
+      float z = corner & 4 ? max[2] : min[2];
+      t.apply(x, y, z);
+      result.include(x, y, z);
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief Ограничивающий бокс и сумма координат набора вершин
+ * (VertexKernels::statistics()).
+ */
+struct VertexStatistics {
+  BoundingBox box;                  ///< Ограничивающий бокс
+  double sum[3] = {0.0, 0.0, 0.0};  ///< Суммы координат по осям
+};
+
+/**
+ * @class VertexSoA
+ * @brief Координаты вершин в виде структуры массивов: x[], y[], z[].
+ *
+ * В таком виде каждая координата лежит подряд, и векторные ядра
+ * обрабатывают 4 (SSE) или 8 (AVX2) вершин за инструкцию без перестановок.
+ */
+class VertexSoA {
+ public:
+  std::vector<float> x;  ///< Координаты X
+  std::vector<float> y;  ///< Координаты Y
+  std::vector<float> z;  ///< Координаты Z
+
+  VertexSoA() = default;
+
+  /**
+   * @brief Создаёт хранилище из count вершин, записанных подряд как x, y, z
+   * (например, из std::vector<Vertex>).
+   */
+  VertexSoA(const float* xyz, size_t count) : x(count), y(count), z(count) {
+    for (size_t i = 0; i < count; ++i) {
+      x[i] = xyz[3 * i];
+      y[i] = xyz[3 * i + 1];
+      z[i] = xyz[3 * i + 2];
+    }
+  }
+
+  /**
+   * @brief Записывает вершины подряд как x, y, z.
+   * @param xyz Буфер на 3 * size() чисел.
+   */
+  void copyTo(float* xyz) const {
+    for (size_t i = 0; i < size(); ++i) {
+      xyz[3 * i] = x[i];
+      xyz[3 * i + 1] = y[i];
+      xyz[3 * i + 2] = z[i];
+    }
+  }
+
+  /**
+   * @brief Возвращает количество вершин.
+   */
+  size_t size() const { return x.size(); }
+};  // class VertexSoA
+
+/**
+ * @class VertexKernels
+ * @brief Векторные ядра для массивов вершин: аффинное преобразование и
+ * ограничивающий бокс.
+ *
+ * Поддерживаются два формата: вершины подряд (x, y, z — как в
+ * std::vector<Vertex>) и VertexSoA. Реализация (AVX2, SSE2 или скалярная)
+ * выбирается во время выполнения; перенос, поворот и масштаб выражаются
+ * через AffineTransform и выполняются одним проходом. Повторные повороты
+ * одних и тех же вершин (Model3D::rotateModel()) считаются в двойной
+ * точности через PreciseRotation.
+ *
+ * Массивы длиннее kParallelGrain вершин делятся между потоками общего
+ * ThreadPool; маленькие модели обрабатываются в вызывающем потоке.
+ */
+class VertexKernels {
+ public:
+  /**
+   * @brief Выбранный набор инструкций; можно изменить, например, в тестах.
+   */
+  static SimdIsa& isa() {
+    static SimdIsa selected = detectSimdIsa();
+    return selected;
+  }
+
+  /**
+   * @brief Наибольшее число потоков для ядер; 0 — все потоки ThreadPool.
+   * Можно изменить, например, в бенчмарках.
+   */
+  static unsigned& maxThreads() {
+    static unsigned threads = 0;
+    return threads;
+  }
+
+  /**
+   * @brief Применяет преобразование к count вершинам, записанным подряд.
+   * @param src Исходные вершины (x, y, z).
+   * @param dst Результат; может совпадать с src.
+   */
+  static void transform(const AffineTransform& t, const float* src,
+                        float* dst, size_t count) {
+    ThreadPool::instance().parallelFor(
+        count, kParallelGrain,
+        [&](size_t begin, size_t end) {
+          transformRange(t, src + 3 * begin, dst + 3 * begin, end - begin);
+        },
+        maxThreads());
+  }
+
+  /**
+   * @brief Применяет преобразование к вершинам VertexSoA на месте.
+   */
+  static void transform(const AffineTransform& t, VertexSoA& vertices) {
+    float* x = vertices.x.data();
+    float* y = vertices.y.data();
+    float* z = vertices.z.data();
+    ThreadPool::instance().parallelFor(
+        vertices.size(), kParallelGrain,
+        [&](size_t begin, size_t end) {
+          transformRange(t, x + begin, y + begin, z + begin, end - begin);
+        },
+        maxThreads());
+  }
+
+  /**
+   * @brief Перенос вершин VertexSoA.
+   */
+  static void translate(VertexSoA& vertices, float dx, float dy, float dz) {
+    transform(AffineTransform::translation(dx, dy, dz), vertices);
+  }
+
+  /**
+   * @brief Масштабирование вершин VertexSoA относительно точки (cx, cy, cz).
+   */
+  static void scale(VertexSoA& vertices, float factor, float cx = 0,
+                    float cy = 0, float cz = 0) {
+    transform(AffineTransform::scaling(factor).about(cx, cy, cz), vertices);
+  }
+
+  /**
+   * @brief Поворот вершин VertexSoA вокруг точки (cx, cy, cz); углы в
+   * градусах, порядок осей как в Model3D::rotateModel().
+   */
+  static void rotate(VertexSoA& vertices, float angleX, float angleY,
+                     float angleZ, float cx = 0, float cy = 0, float cz = 0) {
+    transform(
+        AffineTransform::rotation(angleX, angleY, angleZ).about(cx, cy, cz),
+        vertices);
+  }
+
+  /**
+   * @brief Поворачивает count вершин, записанных подряд, на месте вокруг
+   * точки (cx, cy, cz).
+   *
+   * Вершина переводится в double, поворачивается и округляется до float
+   * один раз, поэтому при многократных поворотах одних и тех же вершин
+   * ошибка не превышает половины единицы младшего разряда за шаг.
+   */
+  static void rotate(const PreciseRotation& r, float cx, float cy, float cz,
+                     float* xyz, size_t count) {
+    const double center[3] = {cx, cy, cz};
+    ThreadPool::instance().parallelFor(
+        count, kParallelGrain,
+        [&](size_t begin, size_t end) {
+          rotateRange(r, center, xyz + 3 * begin, end - begin);
+        },
+        maxThreads());
+  }
+
+  /**
+   * @brief Ограничивающий бокс count вершин, записанных подряд.
+   */
+  static BoundingBox bounds(const float* xyz, size_t count) {
+    BoundingBox box;
+    size_t done = 0;
+#if S21_HAS_SSE2
+    if (isa() != SimdIsa::kScalar) done = boundsAosSse2(xyz, count, box);
+#endif
+    for (size_t i = done; i < count; ++i) {
+      for (int axis = 0; axis < 3; ++axis) {
+        box.min[axis] = std::min(box.min[axis], xyz[3 * i + axis]);
+        box.max[axis] = std::max(box.max[axis], xyz[3 * i + axis]);
+      }
+    }
+    return box;
+  }
+
+  /**
+   * @brief Сумма координат count вершин, записанных подряд.
+   *
+   * Суммы накапливаются в double в нескольких независимых цепочках, что
+   * точнее и быстрее последовательного сложения во float.
+   *
+   * @param total Суммы по осям X, Y, Z.
+   */
+  static void sum(const float* xyz, size_t count, double total[3]) {
+    total[0] = total[1] = total[2] = 0.0;
+    size_t done = 0;
+#if S21_HAS_SSE2
+    if (isa() != SimdIsa::kScalar) done = sumAosSse2(xyz, count, total);
+#endif
+    for (size_t i = done; i < count; ++i) {
+      for (int axis = 0; axis < 3; ++axis) total[axis] += xyz[3 * i + axis];
+    }
+  }
+
+  /**
+   * @brief Ограничивающий бокс и сумма координат count вершин за одно
+   * чтение памяти.
+   *
+   * Массив делится между потоками ThreadPool (не больше threadCount, если
+   * задано, и не меньше kParallelGrain вершин на поток), каждый поток
+   * обходит свою часть блоками по kStatisticsBlock вершин: блок проходят
+   * bounds() и sum(), и второй проход читает его уже из кэша.
+   */
+  static VertexStatistics statistics(const float* xyz, size_t count,
+                                     unsigned threadCount = 0) {
+    VertexStatistics total;
+    std::mutex mutex;
+    ThreadPool::instance().parallelFor(
+        count, kParallelGrain,
+        [&](size_t first, size_t last) {
+          VertexStatistics part;
+          for (size_t block = first; block < last;
+               block += kStatisticsBlock) {
+            size_t size = std::min(kStatisticsBlock, last - block);
+            part.box.merge(bounds(xyz + 3 * block, size));
+            double blockSum[3];
+            sum(xyz + 3 * block, size, blockSum);
+            for (int axis = 0; axis < 3; ++axis) {
+              part.sum[axis] += blockSum[axis];
+            }
+          }
+          std::lock_guard<std::mutex> lock(mutex);
+          total.box.merge(part.box);
+          for (int axis = 0; axis < 3; ++axis) {
+            total.sum[axis] += part.sum[axis];
+          }
+        },
+        threadCount ? threadCount : maxThreads());
+    return total;
+  }
+
+  static constexpr size_t kParallelGrain =
+      1 << 16;  ///< Минимум вершин на поток: меньшие массивы не делятся
+  static constexpr size_t kStatisticsBlock =
+      1 << 14;  ///< Вершин в блоке statistics() (192 КБ, помещается в L2)
+
+  /**
+   * @brief Ограничивающий бокс вершин VertexSoA.
+   */
+  static BoundingBox bounds(const VertexSoA& vertices) {
+    BoundingBox box;
+    const float* axes[3] = {vertices.x.data(), vertices.y.data(),
+                            vertices.z.data()};
+    for (int axis = 0; axis < 3; ++axis) {
+      size_t done = 0;
+#if S21_HAS_SSE2
+      if (isa() != SimdIsa::kScalar) {
+        done = rangeSse2(axes[axis], vertices.size(), box.min[axis],
+                         box.max[axis]);
+      }
+#endif
+      for (size_t i = done; i < vertices.size(); ++i) {
+        box.min[axis] = std::min(box.min[axis], axes[axis][i]);
+        box.max[axis] = std::max(box.max[axis], axes[axis][i]);
+      }
+    }
+    return box;
+  }
+
+ private:
+  /**
+   * @brief Последовательное преобразование части массива вершин подряд.
+   */
+  static void transformRange(const AffineTransform& t, const float* src,
+                             float* dst, size_t count) {
+    size_t done = 0;
+
+    switch (isa()) {
+#if S21_HAS_AVX2
+      case SimdIsa::kAvx2:
+        done = transformAosAvx2(t, src, dst, count);
+        break;
+#endif
+#if S21_HAS_SSE2
+      case SimdIsa::kSse2:
+        done = transformAosSse2(t, src, dst, count);
+        break;
+#endif
+      default:
+        break;
+    }
+    for (size_t i = done; i < count; ++i) {
+      float x = src[3 * i], y = src[3 * i + 1], z = src[3 * i + 2];
+      t.apply(x, y, z);
+      dst[3 * i] = x;
+      dst[3 * i + 1] = y;
+      dst[3 * i + 2] = z;
+    }
+  }
+
+  /**
+   * @brief Последовательное преобразование части массивов VertexSoA.
+   */
+  static void transformRange(const AffineTransform& t, float* x, float* y,
+                             float* z, size_t count) {
+    size_t done = 0;
+    switch (isa()) {
+#if S21_HAS_AVX2
+      case SimdIsa::kAvx2:
+        done = transformSoaAvx2(t, x, y, z, count);
+        break;
+#endif
+#if S21_HAS_SSE2
+      case SimdIsa::kSse2:
+        done = transformSoaSse2(t, x, y, z, count);
+        break;
+#endif
+      default:
+        break;
+    }
+    for (size_t i = done; i < count; ++i) t.apply(x[i], y[i], z[i]);
+  }
+
+  /**
+   * @brief Последовательный поворот части вершин в двойной точности.
+   */
+  static void rotateRange(const PreciseRotation& r, const double* center,
+                          float* xyz, size_t count) {
+    size_t done = 0;
+    switch (isa()) {
+#if S21_HAS_AVX2
+      case SimdIsa::kAvx2:
+        done = rotateAosAvx2(r, center, xyz, count);
+        break;
+#endif
+#if S21_HAS_SSE2
+      case SimdIsa::kSse2:
+        done = rotateAosSse2(r, center, xyz, count);
+        break;
+#endif
+      default:
+        break;
+    }
+    for (size_t i = done; i < count; ++i) {
+      float* point = xyz + 3 * i;
+      double d[3] = {point[0] - center[0], point[1] - center[1],
+                     point[2] - center[2]};
+      for (int row = 0; row < 3; ++row) {
+        point[row] = static_cast<float>(center[row] + r.m[row][0] * d[0] +
+                                        r.m[row][1] * d[1] +
+                                        r.m[row][2] * d[2]);
+      }
+    }
+  }
+
+#if S21_HAS_SSE2
+  /**
+   * @brief Разбирает 4 вершины (3 регистра x,y,z подряд) на регистры X, Y, Z.
+   */
+  static void deinterleave(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y,
+                           __m128& z) {
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    __m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2));
+    x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(3, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                       _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                       _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+  }
+
+  /**
+   * @brief Обратная к deinterleave() перестановка.
+   */
+  static void interleave(__m128 x, __m128 y, __m128 z, __m128& a, __m128& b,
+                         __m128& c) {
+    a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)),
+                       _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+    b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+                       _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+    c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+                       _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+  }
+
+  /**
+   * @brief Строка матрицы, применённая к регистрам X, Y, Z.
+   */
+  static __m128 row(const float* r, __m128 x, __m128 y, __m128 z) {
+    __m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[0]), x),
+                               _mm_set1_ps(r[3]));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(r[1]), y));
+    return _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(r[2]), z));
+  }
+
+  static size_t transformAosSse2(const AffineTransform& t, const float* src,
+                                 float* dst, size_t count) {
+    size_t blocks = count / 4;
+    for (size_t i = 0; i < blocks; ++i, src += 12, dst += 12) {
+      __m128 x, y, z;
+      deinterleave(_mm_loadu_ps(src), _mm_loadu_ps(src + 4),
+                   _mm_loadu_ps(src + 8), x, y, z);
+      __m128 a, b, c;
+      interleave(row(t.m[0], x, y, z), row(t.m[1], x, y, z),
+                 row(t.m[2], x, y, z), a, b, c);
+      _mm_storeu_ps(dst, a);
+      _mm_storeu_ps(dst + 4, b);
+      _mm_storeu_ps(dst + 8, c);
+    }
+    return blocks * 4;
+  }
+
+  static size_t transformSoaSse2(const AffineTransform& t, float* x, float* y,
+                                 float* z, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 vx = _mm_loadu_ps(x + i);
+      __m128 vy = _mm_loadu_ps(y + i);
+      __m128 vz = _mm_loadu_ps(z + i);
+      _mm_storeu_ps(x + i, row(t.m[0], vx, vy, vz));
+      _mm_storeu_ps(y + i, row(t.m[1], vx, vy, vz));
+      _mm_storeu_ps(z + i, row(t.m[2], vx, vy, vz));
+    }
+    return i;
+  }
+
+  /**
+   * @brief Строка поворота в двойной точности для двух вершин.
+   */
+  static __m128d rowPrecise(const double* r, double center, __m128d x,
+                            __m128d y, __m128d z) {
+    __m128d result = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(r[0]), x),
+                                _mm_set1_pd(center));
+    result = _mm_add_pd(result, _mm_mul_pd(_mm_set1_pd(r[1]), y));
+    return _mm_add_pd(result, _mm_mul_pd(_mm_set1_pd(r[2]), z));
+  }
+
+  /**
+   * @brief Строка поворота для 4 вершин: две половины регистра float
+   * переводятся в double, результат собирается обратно во float.
+   */
+  static __m128 rowPrecise4(const double* r, double center, const __m128d* x,
+                            const __m128d* y, const __m128d* z) {
+    return _mm_movelh_ps(
+        _mm_cvtpd_ps(rowPrecise(r, center, x[0], y[0], z[0])),
+        _mm_cvtpd_ps(rowPrecise(r, center, x[1], y[1], z[1])));
+  }
+
+  static size_t rotateAosSse2(const PreciseRotation& r, const double* center,
+                              float* xyz, size_t count) {
+    size_t blocks = count / 4;
+    for (size_t i = 0; i < blocks; ++i, xyz += 12) {
+      __m128 x, y, z;
+      deinterleave(_mm_loadu_ps(xyz), _mm_loadu_ps(xyz + 4),
+                   _mm_loadu_ps(xyz + 8), x, y, z);
+      __m128 lanes[3] = {x, y, z};
+      __m128d d[3][2];
+      for (int axis = 0; axis < 3; ++axis) {
+        __m128d c = _mm_set1_pd(center[axis]);
+        d[axis][0] = _mm_sub_pd(_mm_cvtps_pd(lanes[axis]), c);
+        d[axis][1] = _mm_sub_pd(
+            _mm_cvtps_pd(_mm_movehl_ps(lanes[axis], lanes[axis])), c);
+      }
+      __m128 a, b, c;
+      interleave(rowPrecise4(r.m[0], center[0], d[0], d[1], d[2]),
+                 rowPrecise4(r.m[1], center[1], d[0], d[1], d[2]),
+                 rowPrecise4(r.m[2], center[2], d[0], d[1], d[2]), a, b, c);
+      _mm_storeu_ps(xyz, a);
+      _mm_storeu_ps(xyz + 4, b);
+      _mm_storeu_ps(xyz + 8, c);
+    }
+    return blocks * 4;
+  }
+
+  /**
+   * @brief Границы без перестановок, как в sumAosSse2(): позиции блока из
+   * 12 чисел соответствуют осям x y z x | y z x y | z x y z.
+   */
+  static size_t boundsAosSse2(const float* xyz, size_t count,
+                              BoundingBox& box) {
+    size_t blocks = count / 4;
+    if (blocks == 0) return 0;
+    __m128 lo[3], hi[3];
+    for (int k = 0; k < 3; ++k) {
+      lo[k] = _mm_loadu_ps(xyz + 4 * k);
+      hi[k] = lo[k];
+    }
+    for (size_t i = 1; i < blocks; ++i) {
+      for (int k = 0; k < 3; ++k) {
+        __m128 v = _mm_loadu_ps(xyz + 12 * i + 4 * k);
+        lo[k] = _mm_min_ps(lo[k], v);
+        hi[k] = _mm_max_ps(hi[k], v);
+      }
+    }
+    alignas(16) float mins[12], maxs[12];
+    for (int k = 0; k < 3; ++k) {
+      _mm_store_ps(mins + 4 * k, lo[k]);
+      _mm_store_ps(maxs + 4 * k, hi[k]);
+    }
+    for (int lane = 0; lane < 12; ++lane) {
+      box.min[lane % 3] = std::min(box.min[lane % 3], mins[lane]);
+      box.max[lane % 3] = std::max(box.max[lane % 3], maxs[lane]);
+    }
+    return blocks * 4;
+  }
+
+  /**
+   * @brief Сумма без перестановок: в блоке из 12 чисел каждая позиция
+   * всегда относится к одной и той же оси, поэтому три регистра блока
+   * складываются как есть, а оси разбираются только в конце. Частичные
+   * суммы во float сбрасываются в double каждые kSumFlush блоков.
+   */
+  static size_t sumAosSse2(const float* xyz, size_t count, double total[3]) {
+    size_t blocks = count / 4;
+    double lanes[12] = {};
+    for (size_t first = 0; first < blocks; first += kSumFlush) {
+      size_t last = std::min(blocks, first + kSumFlush);
+      __m128 a = _mm_setzero_ps(), b = _mm_setzero_ps(), c = _mm_setzero_ps();
+      for (size_t i = first; i < last; ++i) {
+        a = _mm_add_ps(a, _mm_loadu_ps(xyz + 12 * i));
+        b = _mm_add_ps(b, _mm_loadu_ps(xyz + 12 * i + 4));
+        c = _mm_add_ps(c, _mm_loadu_ps(xyz + 12 * i + 8));
+      }
+      alignas(16) float partial[12];
+      _mm_store_ps(partial, a);
+      _mm_store_ps(partial + 4, b);
+      _mm_store_ps(partial + 8, c);
+      for (int lane = 0; lane < 12; ++lane) lanes[lane] += partial[lane];
+    }
+    for (int lane = 0; lane < 12; ++lane) total[lane % 3] += lanes[lane];
+    return blocks * 4;
+  }
+
+  static constexpr size_t kSumFlush = 256;  ///< Блоков между сбросами в double
+
+  static size_t rangeSse2(const float* values, size_t count, float& min,
+                          float& max) {
+    __m128 lo = _mm_set1_ps(min);
+    __m128 hi = _mm_set1_ps(max);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 v = _mm_loadu_ps(values + i);
+      lo = _mm_min_ps(lo, v);
+      hi = _mm_max_ps(hi, v);
+    }
+    min = horizontal(lo, min, false);
+    max = horizontal(hi, max, true);
+    return i;
+  }
+
+  /**
+   * @brief Минимум или максимум элементов регистра и начального значения.
+   */
+  static float horizontal(__m128 v, float initial, bool takeMax) {
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, v);
+    for (float lane : lanes) {
+      initial = takeMax ? std::max(initial, lane) : std::min(initial, lane);
+    }
+    return initial;
+  }
+#endif
+
+#if S21_HAS_AVX2
+  /**
+   * @brief Строка матрицы, применённая к регистрам X, Y, Z (AVX2 + FMA).
+   */
+  S21_TARGET_AVX2
+  static __m256 row256(const float* r, __m256 x, __m256 y, __m256 z) {
+    __m256 result = _mm256_fmadd_ps(_mm256_set1_ps(r[0]), x,
+                                    _mm256_set1_ps(r[3]));
+    result = _mm256_fmadd_ps(_mm256_set1_ps(r[1]), y, result);
+    return _mm256_fmadd_ps(_mm256_set1_ps(r[2]), z, result);
+  }
+
+  /**
+   * @brief Вершины подряд, по 8 за итерацию: каждая 128-битная половина
+   * регистра содержит блок из 4 вершин, и перестановки deinterleave()
+   * выполняются в обеих половинах одновременно.
+   */
+  S21_TARGET_AVX2
+  static size_t transformAosAvx2(const AffineTransform& t, const float* src,
+                                 float* dst, size_t count) {
+    size_t blocks = count / 8;
+    for (size_t i = 0; i < blocks; ++i, src += 24, dst += 24) {
+      __m256 a = _mm256_loadu2_m128(src + 12, src);
+      __m256 b = _mm256_loadu2_m128(src + 16, src + 4);
+      __m256 c = _mm256_loadu2_m128(src + 20, src + 8);
+
+      __m256 bc = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2));
+      __m256 x = _mm256_shuffle_ps(a, bc, _MM_SHUFFLE(3, 0, 3, 0));
+      __m256 y = _mm256_shuffle_ps(
+          _mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+          _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+          _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 z = _mm256_shuffle_ps(
+          _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+          _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+          _MM_SHUFFLE(2, 0, 2, 0));
+
+      __m256 nx = row256(t.m[0], x, y, z);
+      __m256 ny = row256(t.m[1], x, y, z);
+      __m256 nz = row256(t.m[2], x, y, z);
+
+      a = _mm256_shuffle_ps(_mm256_shuffle_ps(nx, ny, _MM_SHUFFLE(0, 0, 0, 0)),
+                            _mm256_shuffle_ps(nz, nx, _MM_SHUFFLE(1, 1, 0, 0)),
+                            _MM_SHUFFLE(2, 0, 2, 0));
+      b = _mm256_shuffle_ps(_mm256_shuffle_ps(ny, nz, _MM_SHUFFLE(1, 1, 1, 1)),
+                            _mm256_shuffle_ps(nx, ny, _MM_SHUFFLE(2, 2, 2, 2)),
+                            _MM_SHUFFLE(2, 0, 2, 0));
+      c = _mm256_shuffle_ps(_mm256_shuffle_ps(nz, nx, _MM_SHUFFLE(3, 3, 2, 2)),
+                            _mm256_shuffle_ps(ny, nz, _MM_SHUFFLE(3, 3, 3, 3)),
+                            _MM_SHUFFLE(2, 0, 2, 0));
+      _mm256_storeu2_m128(dst + 12, dst, a);
+      _mm256_storeu2_m128(dst + 16, dst + 4, b);
+      _mm256_storeu2_m128(dst + 20, dst + 8, c);
+    }
+    return blocks * 8;
+  }
+
+  S21_TARGET_AVX2
+  static size_t transformSoaAvx2(const AffineTransform& t, float* x, float* y,
+                                 float* z, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m256 vx = _mm256_loadu_ps(x + i);
+      __m256 vy = _mm256_loadu_ps(y + i);
+      __m256 vz = _mm256_loadu_ps(z + i);
+      _mm256_storeu_ps(x + i, row256(t.m[0], vx, vy, vz));
+      _mm256_storeu_ps(y + i, row256(t.m[1], vx, vy, vz));
+      _mm256_storeu_ps(z + i, row256(t.m[2], vx, vy, vz));
+    }
+    return i;
+  }
+
+  /**
+   * @brief Строка поворота в двойной точности: center + r * (x, y, z).
+   */
+  S21_TARGET_AVX2
+  static __m256d rowPrecise(const double* r, double center, __m256d x,
+                            __m256d y, __m256d z) {
+    __m256d result = _mm256_fmadd_pd(_mm256_set1_pd(r[0]), x,
+                                     _mm256_set1_pd(center));
+    result = _mm256_fmadd_pd(_mm256_set1_pd(r[1]), y, result);
+    return _mm256_fmadd_pd(_mm256_set1_pd(r[2]), z, result);
+  }
+
+  /**
+   * @brief Поворот вершин подряд в двойной точности, по 4 за итерацию:
+   * перестановки deinterleave() в float, вычисления в регистрах double.
+   */
+  S21_TARGET_AVX2
+  static size_t rotateAosAvx2(const PreciseRotation& r, const double* center,
+                              float* xyz, size_t count) {
+    __m256d cx = _mm256_set1_pd(center[0]);
+    __m256d cy = _mm256_set1_pd(center[1]);
+    __m256d cz = _mm256_set1_pd(center[2]);
+    size_t blocks = count / 4;
+    for (size_t i = 0; i < blocks; ++i, xyz += 12) {
+      __m128 x, y, z;
+      deinterleave(_mm_loadu_ps(xyz), _mm_loadu_ps(xyz + 4),
+                   _mm_loadu_ps(xyz + 8), x, y, z);
+      __m256d dx = _mm256_sub_pd(_mm256_cvtps_pd(x), cx);
+      __m256d dy = _mm256_sub_pd(_mm256_cvtps_pd(y), cy);
+      __m256d dz = _mm256_sub_pd(_mm256_cvtps_pd(z), cz);
+      __m128 a, b, c;
+      interleave(_mm256_cvtpd_ps(rowPrecise(r.m[0], center[0], dx, dy, dz)),
+                 _mm256_cvtpd_ps(rowPrecise(r.m[1], center[1], dx, dy, dz)),
+                 _mm256_cvtpd_ps(rowPrecise(r.m[2], center[2], dx, dy, dz)),
+                 a, b, c);
+      _mm_storeu_ps(xyz, a);
+      _mm_storeu_ps(xyz + 4, b);
+      _mm_storeu_ps(xyz + 8, c);
+    }
+    return blocks * 4;
+  }
+#endif
+};  // class VertexKernels
+
+}  // namespace s21
+
+#endif  // VERTEX_KERNELS_H
@@ -0,0 +1,186 @@
+/**
+ * @file mappedfile.h
+ * @brief Класс MappedFile — доступ к содержимому файла только для чтения
+ * через отображение в память.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define S21_HAS_MMAP 1
+#else
+#define S21_HAS_MMAP 0
+#endif
+
+namespace s21 {
+
+/**
+ * @class MappedFile
+ * @brief Отображает файл в память только для чтения.
+ *
+ * Если отображение недоступно (другая платформа, специальный файл, ошибка
+ * mmap), содержимое читается целиком во внутренний буфер. В обоих случаях
+ * данные доступны через view() без дополнительных копий.
+ */
+class MappedFile {
+ public:
+  MappedFile() = default;
+
+  /**
+   * @brief Открывает и отображает файл.
+   * @param filename Путь к файлу.
+   */
+  explicit MappedFile(const std::string& filename) { open(filename); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * @brief Деструктор. Снимает отображение файла.
+   */
+  ~MappedFile() { close(); }
+
+  /**
+   * @brief Открывает файл: сначала пытается отобразить его в память, при
+   * неудаче читает в буфер.
+   * @param filename Путь к файлу.
+   * @return true если содержимое файла доступно.
+   */
+  bool open(const std::string& filename) {
+    close();
+    if (mapFile(filename)) return true;
+    return readFile(filename);
+  }
+
+  /**
+   * @brief Освобождает отображение или буфер.
+   */
+  void close() {
+#if S21_HAS_MMAP
+    if (mapped_ && data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    open_ = false;
+  }
+
+  /**
+   * @brief Проверяет, доступно ли содержимое файла.
+   */
+  bool isOpen() const { return open_; }
+
+  /**
+   * @brief Возвращает true, если файл отображён в память, а не прочитан в
+   * буфер.
+   */
+  bool isMapped() const { return mapped_; }
+
+  /**
+   * @brief Указатель на начало содержимого файла.
+   */
+  const char* data() const { return data_; }
+
+  /**
+   * @brief Размер содержимого файла в байтах.
+   */
+  size_t size() const { return size_; }
+
+  /**
+   * @brief Содержимое файла в виде std::string_view.
+   */
+  std::string_view view() const { return std::string_view(data_, size_); }
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  bool open_ = false;
+  std::string buffer_;  ///< Буфер для режима чтения без отображения
+
+  /**
+   * @brief Отображает файл в память через mmap.
+   */
+  bool mapFile(const std::string& filename) {
+#if S21_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      ::close(fd);
+      return false;
+    }
+
+    if (st.st_size == 0) {  // Пустой файл нельзя отобразить
+      ::close(fd);
+      data_ = buffer_.data();
+      open_ = true;
+      return true;
+    }
+
+    void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                        MAP_PRIVATE, fd, 0);
+    ::close(fd);  // Отображение остаётся действительным после закрытия
+    if (addr == MAP_FAILED) return false;
+
+#ifdef MADV_SEQUENTIAL
+    ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+    data_ = static_cast<const char*>(addr);
+    size_ = static_cast<size_t>(st.st_size);
+    mapped_ = true;
+    open_ = true;
+    return true;
+#else
+    (void)filename;
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Читает файл целиком во внутренний буфер.
+   */
+  bool readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (length > 0) {
+      buffer_.resize(static_cast<size_t>(length));
+      file.read(buffer_.data(), length);
+      buffer_.resize(static_cast<size_t>(file.gcount()));
+    } else {  // Размер неизвестен (например, канал) — читаем блоками
+      file.clear();
+      char chunk[1 << 16];
+      while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+        buffer_.append(chunk, static_cast<size_t>(file.gcount()));
+      }
+    }
+
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    open_ = true;
+    return true;
+  }
+};  // class MappedFile
+
+}  // namespace s21
+
+#endif  // MAPPED_FILE_H
@@ -0,0 +1,301 @@
+/**
+ * @file meshcache.h
+ * @brief Класс MeshCache — двоичный кэш загруженных моделей.
+ */
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include "../core/model3d.h"
+#include "../core/quantizedpositions.h"
+#include "mappedfile.h"
+
+namespace s21 {
+
+/**
+ * @brief Заголовок файла кэша модели.
+ *
+ * За заголовком следуют путь к исходному файлу (pathLength байт, дополненный
+ * до 8 байт), координаты вершин (3 float на вершину или, с флагом
+ * MeshCache::kQuantizedPositions, 3 uint16 относительно bboxMin и bboxMax,
+ * дополненные до 8 байт), размеры полигонов (uint32 на полигон) и индексы
+ * вершин полигонов (int32).
+ */
+struct MeshCacheHeader {
+  char magic[8];             ///< Сигнатура файла кэша
+  uint32_t version;          ///< Версия формата
+  uint32_t pathLength;       ///< Длина пути к исходному файлу
+  uint64_t sourceSize;       ///< Размер исходного файла
+  int64_t sourceMtime;       ///< Время изменения исходного файла
+  uint64_t vertexCount;      ///< Число вершин
+  uint64_t polygonCount;     ///< Число полигонов
+  uint64_t indexCount;       ///< Суммарное число индексов полигонов
+  float bboxMin[3];          ///< Минимальный угол ограничивающего бокса
+  float bboxMax[3];          ///< Максимальный угол ограничивающего бокса
+  uint32_t flags;            ///< Флаги формата (MeshCache::kQuantizedPositions)
+  uint32_t reserved;         ///< Выравнивание заголовка до 8 байт
+};
+
+/**
+ * @class MeshCache
+ * @brief Сохраняет нормализованную модель в компактном двоичном формате и
+ * восстанавливает её без разбора текста.
+ *
+ * Кэш привязан к пути, размеру и времени изменения исходного .obj-файла;
+ * при изменении любого из них кэш считается устаревшим. При чтении файл
+ * кэша отображается в память, и массивы копируются в модель целиком.
+ *
+ * По запросу координаты хранятся в 16-битном виде (PositionQuantizer): блок
+ * вершин вдвое меньше, и файл читается быстрее ценой ошибки не больше
+ * половины шага сетки бокса.
+ */
+class MeshCache {
+ public:
+  static constexpr char kMagic[8] = {'S', '2', '1', 'M', 'E', 'S', 'H', '\0'};
+  static constexpr uint32_t kVersion = 2;
+  static constexpr uint32_t kQuantizedPositions =
+      1;  ///< Флаг: координаты вершин хранятся в 16-битном виде
+
+  /**
+   * @brief Возвращает путь к файлу кэша для исходного файла.
+   * @param cacheDir Каталог кэша
+   * @param sourcePath Путь к исходному .obj-файлу
+   */
+  static std::string cachePath(const std::string& cacheDir,
+                               const std::string& sourcePath) {
+    // FNV-1a от пути к исходному файлу
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : sourcePath) {
+      hash = (hash ^ c) * 1099511628211ULL;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.v3dcache",
+                  static_cast<unsigned long long>(hash));
+    return (std::filesystem::path(cacheDir) / name).string();
+  }
+
+  /**
+   * @brief Записывает модель в файл кэша.
+   *
+   * Файл сначала пишется во временный, затем переименовывается, поэтому
+   * читатели никогда не видят недописанный кэш.
+   *
+   * @param cacheFile Путь к файлу кэша
+   * @param sourcePath Путь к исходному .obj-файлу
+   * @param model Нормализованная модель
+   * @param quantized Хранить координаты в 16-битном виде
+   * @return true если кэш записан
+   */
+  static bool write(const std::string& cacheFile,
+                    const std::string& sourcePath, const Model3D& model,
+                    bool quantized = false) {
+    MeshCacheHeader header{};
+    if (!fillSourceKey(sourcePath, header)) return false;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.pathLength = static_cast<uint32_t>(sourcePath.size());
+    header.vertexCount = model.vertices.size();
+    header.polygonCount = model.polygons.size();
+    header.indexCount = model.polygons.indexCount();
+    // Бокс уже известен модели (считается при нормализации)
+    BoundingBox box = model.bounds();
+    if (!box.empty()) {
+      std::memcpy(header.bboxMin, box.min, sizeof(header.bboxMin));
+      std::memcpy(header.bboxMax, box.max, sizeof(header.bboxMax));
+    }
+    if (quantized) header.flags |= kQuantizedPositions;
+
+    std::error_code error;
+    std::filesystem::create_directories(
+        std::filesystem::path(cacheFile).parent_path(), error);
+
+    std::string tempFile = cacheFile + ".tmp";
+    {
+      std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+      if (!out.is_open()) return false;
+
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(sourcePath.data(), sourcePath.size());
+      static const char padding[8] = {};
+      out.write(padding, paddedLength(sourcePath.size()) - sourcePath.size());
+
+      if (quantized) {
+        std::vector<QuantizedPosition> packed(model.vertices.size());
+        quantizerFor(header).encode(
+            reinterpret_cast<const float*>(model.vertices.data()),
+            packed.size(), packed.data());
+        uint64_t bytes = packed.size() * sizeof(QuantizedPosition);
+        out.write(reinterpret_cast<const char*>(packed.data()), bytes);
+        out.write(padding, paddedLength(bytes) - bytes);
+      } else {
+        out.write(reinterpret_cast<const char*>(model.vertices.data()),
+                  model.vertices.size() * sizeof(Vertex));
+      }
+      for (PolygonView polygon : model.polygons) {
+        uint32_t size = static_cast<uint32_t>(polygon.size());
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+      }
+      // Индексы граней в модели уже лежат подряд (PolygonList)
+      const std::vector<int>& indices = model.polygons.indices();
+      out.write(reinterpret_cast<const char*>(indices.data()),
+                indices.size() * sizeof(int32_t));
+      if (!out.good()) {
+        out.close();
+        std::filesystem::remove(tempFile, error);
+        return false;
+      }
+    }
+
+    std::filesystem::rename(tempFile, cacheFile, error);
+    if (error) std::filesystem::remove(tempFile, error);
+    return !error;
+  }
+
+  /**
+   * @brief Загружает модель из файла кэша, если он актуален.
+   * @param cacheFile Путь к файлу кэша
+   * @param sourcePath Путь к исходному .obj-файлу
+   * @param model Модель, в которую загружаются данные (очищается)
+   * @param header Если не nullptr, сюда копируется заголовок кэша
+   * @return true если кэш актуален и модель загружена
+   * @throw std::bad_alloc если памяти для модели не хватает
+   */
+  static bool read(const std::string& cacheFile, const std::string& sourcePath,
+                   Model3D& model, MeshCacheHeader* header = nullptr) {
+    MeshCacheHeader expected{};
+    if (!fillSourceKey(sourcePath, expected)) return false;
+
+    MappedFile file;
+    if (!file.open(cacheFile)) return false;
+    if (file.size() < sizeof(MeshCacheHeader)) return false;
+
+    MeshCacheHeader stored;
+    std::memcpy(&stored, file.data(), sizeof(stored));
+    if (std::memcmp(stored.magic, kMagic, sizeof(kMagic)) != 0 ||
+        stored.version != kVersion ||
+        stored.sourceSize != expected.sourceSize ||
+        stored.sourceMtime != expected.sourceMtime ||
+        stored.pathLength != sourcePath.size()) {
+      return false;
+    }
+
+    const char* data = file.data() + sizeof(MeshCacheHeader);
+    if (std::string_view(data, stored.pathLength) != sourcePath) return false;
+    data += paddedLength(stored.pathLength);
+
+    // Счётчики ограничены размером файла до умножения: иначе испорченный
+    // заголовок мог бы переполнить expectedSize и совпасть с размером
+    bool quantized = stored.flags & kQuantizedPositions;
+    uint64_t vertexSize =
+        quantized ? sizeof(QuantizedPosition) : 3 * sizeof(float);
+    if (stored.vertexCount > file.size() / vertexSize ||
+        stored.polygonCount > file.size() / sizeof(uint32_t) ||
+        stored.indexCount > file.size() / sizeof(int32_t)) {
+      return false;
+    }
+    uint64_t vertexBytes =
+        quantized
+            ? paddedLength(stored.vertexCount * sizeof(QuantizedPosition))
+            : stored.vertexCount * 3 * sizeof(float);
+    uint64_t expectedSize = sizeof(MeshCacheHeader) +
+                            paddedLength(stored.pathLength) + vertexBytes +
+                            stored.polygonCount * sizeof(uint32_t) +
+                            stored.indexCount * sizeof(int32_t);
+    if (file.size() != expectedSize || stored.indexCount > UINT32_MAX) {
+      return false;
+    }
+
+    model.clear();
+    model.vertices.resize(stored.vertexCount);
+    float* xyz = reinterpret_cast<float*>(model.vertices.data());
+    if (quantized) {
+      quantizerFor(stored).decode(
+          reinterpret_cast<const QuantizedPosition*>(data),
+          stored.vertexCount, xyz);
+    } else {
+      std::memcpy(xyz, data, stored.vertexCount * sizeof(Vertex));
+    }
+    data += vertexBytes;
+
+    const char* sizes = data;
+    const char* indexData = data + stored.polygonCount * sizeof(uint32_t);
+    std::vector<int> indices(stored.indexCount);
+    std::memcpy(indices.data(), indexData, indices.size() * sizeof(int32_t));
+    for (int index : indices) {
+      if (index < 0 || static_cast<uint64_t>(index) >= stored.vertexCount) {
+        model.clear();
+        return false;
+      }
+    }
+
+    std::vector<uint32_t> ends(stored.polygonCount);
+    uint64_t indexTotal = 0;
+    for (uint64_t i = 0; i < stored.polygonCount; ++i) {
+      uint32_t size;
+      std::memcpy(&size, sizes + i * sizeof(uint32_t), sizeof(size));
+      indexTotal += size;
+      if (indexTotal > stored.indexCount) {
+        model.clear();
+        return false;
+      }
+      ends[i] = static_cast<uint32_t>(indexTotal);
+    }
+    if (indexTotal != stored.indexCount) {
+      model.clear();
+      return false;
+    }
+    model.polygons.assign(std::move(ends), std::move(indices));
+    model.resetPosition();
+
+    if (header) *header = stored;
+    return true;
+  }
+
+ private:
+  /**
+   * @brief Заполняет ключ кэша: размер и время изменения исходного файла.
+   */
+  static bool fillSourceKey(const std::string& sourcePath,
+                            MeshCacheHeader& header) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(sourcePath, error);
+    if (error) return false;
+    auto mtime = std::filesystem::last_write_time(sourcePath, error);
+    if (error) return false;
+    header.sourceSize = size;
+    header.sourceMtime = static_cast<int64_t>(
+        mtime.time_since_epoch().count());
+    return true;
+  }
+
+  /**
+   * @brief Сетка 16-битных координат по боксу из заголовка.
+   */
+  static PositionQuantizer quantizerFor(const MeshCacheHeader& header) {
+    BoundingBox box;
+    if (header.vertexCount > 0) {
+      for (int axis = 0; axis < 3; ++axis) {
+        box.min[axis] = header.bboxMin[axis];
+        box.max[axis] = header.bboxMax[axis];
+      }
+    }
+    return PositionQuantizer(box);
+  }
+
+  /**
+   * @brief Длина, дополненная до границы 8 байт.
+   */
+  static uint64_t paddedLength(uint64_t length) { return (length + 7) & ~7ULL; }
+};  // class MeshCache
+
+}  // namespace s21
+
+#endif  // MESH_CACHE_H
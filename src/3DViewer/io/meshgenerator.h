@@ -0,0 +1,497 @@
+/**
+ * @file meshgenerator.h
+ * @brief Класс MeshGenerator — синтетические модели заданного размера для
+ * нагрузочных тестов и бенчмарков.
+ */
+
+#ifndef MESH_GENERATOR_H
+#define MESH_GENERATOR_H
+
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../core/model3d.h"
+
+namespace s21 {
+
+/**
+ * @brief Форма синтетической модели.
+ */
+enum class MeshShape {
+  kSphere,  ///< Сфера из колец и сегментов (треугольники у полюсов)
+  kGrid,    ///< Квадратная сетка-рельеф из четырёхугольников
+  kTorus,   ///< Тор из четырёхугольников
+  kSoup     ///< Случайный набор 3-, 4- и n-угольников
+};
+
+/**
+ * @brief Запись индексов граней в OBJ.
+ */
+enum class ObjIndexStyle {
+  kPositive,  ///< Абсолютные индексы с единицы
+  kNegative,  ///< Индексы относительно последней вершины (-1 — последняя)
+  kMixed      ///< Чётные грани — абсолютные, нечётные — относительные
+};
+
+/**
+ * @brief Параметры синтетической модели.
+ */
+struct MeshSpec {
+  MeshShape shape = MeshShape::kGrid;  ///< Форма
+  size_t faces = 1000;                 ///< Желаемое число граней
+  uint64_t seed = 1;                   ///< Зерно случайных смещений
+};
+
+/**
+ * @class ObjWriter
+ * @brief Потоковая запись вершин и граней в текст OBJ.
+ *
+ * Текст накапливается в буфере и, если задан файл, сбрасывается в него
+ * блоками по kFlushSize байт, поэтому модель любого размера записывается
+ * без её построения в памяти. Координаты записываются кратчайшей строкой,
+ * которая читается обратно в то же значение float.
+ */
+class ObjWriter {
+ public:
+  static constexpr size_t kFlushSize =
+      size_t(1) << 20;  ///< Размер блока записи в файл
+
+  /**
+   * @brief Запись в строку out (дописывается в конец).
+   */
+  ObjWriter(std::string& out, ObjIndexStyle style)
+      : text_(out), style_(style) {}
+
+  /**
+   * @brief Запись в открытый файл file.
+   */
+  ObjWriter(std::FILE* file, ObjIndexStyle style)
+      : text_(buffer_), file_(file), style_(style) {}
+
+  ObjWriter(const ObjWriter&) = delete;
+  ObjWriter& operator=(const ObjWriter&) = delete;
+
+  /**
+   * @brief Строка комментария (без символа #).
+   */
+  void comment(std::string_view text) {
+    text_ += "# ";
+    text_ += text;
+    text_ += '\n';
+  }
+
+  /**
+   * @brief Приёмник MeshGenerator::generate(): размер текста заранее не
+   * известен, резервировать нечего.
+   */
+  void reserve(size_t, size_t, size_t) {}
+
+  void vertex(float x, float y, float z) {
+    text_ += 'v';
+    for (float value : {x, y, z}) {
+      char digits[32] = " ";
+      auto result = std::to_chars(digits + 1, digits + sizeof(digits), value);
+      text_.append(digits, result.ptr);
+    }
+    text_ += '\n';
+    ++vertexCount_;
+    flushIfFull();
+  }
+
+  /**
+   * @brief Грань по индексам вершин с нуля.
+   */
+  void face(std::span<const int> indices) {
+    bool relative = style_ == ObjIndexStyle::kNegative ||
+                    (style_ == ObjIndexStyle::kMixed && faceCount_ % 2 == 1);
+    text_ += 'f';
+    for (int index : indices) {
+      long long value = relative ? index - vertexCount_ : index + 1LL;
+      char digits[24] = " ";
+      auto result = std::to_chars(digits + 1, digits + sizeof(digits), value);
+      text_.append(digits, result.ptr);
+    }
+    text_ += '\n';
+    ++faceCount_;
+    flushIfFull();
+  }
+
+  /**
+   * @brief Сбрасывает остаток буфера в файл.
+   * @return false при ошибке записи.
+   */
+  bool finish() {
+    if (file_ && !text_.empty()) {
+      std::fwrite(text_.data(), 1, text_.size(), file_);
+      text_.clear();
+    }
+    return !file_ || std::ferror(file_) == 0;
+  }
+
+ private:
+  void flushIfFull() {
+    if (file_ && text_.size() >= kFlushSize) finish();
+  }
+
+  std::string buffer_;         ///< Буфер записи в файл
+  std::string& text_;          ///< Куда дописывается текст
+  std::FILE* file_ = nullptr;  ///< Файл или nullptr для записи в строку
+  ObjIndexStyle style_;        ///< Запись индексов граней
+  long long vertexCount_ = 0;  ///< Записано вершин
+  size_t faceCount_ = 0;       ///< Записано граней
+};  // class ObjWriter
+
+/**
+ * @class MeshGenerator
+ * @brief Строит модели заданной формы и размера детерминированно по зерну.
+ *
+ * Вершины и грани передаются приёмнику по мере построения (generate()),
+ * поэтому одна и та же модель может быть собрана в Model3D (model()) или
+ * записана в OBJ-файл любого размера (writeObj()) без промежуточной копии.
+ * Случайные числа берутся из SplitMix64 и переводятся в float без
+ * std::*_distribution, так что при одном зерне результат одинаков на всех
+ * платформах.
+ */
+class MeshGenerator {
+ public:
+  /**
+   * @brief Передаёт модель приёмнику sink.
+   *
+   * Приёмник получает reserve(vertices, faces, indices), затем вершины
+   * vertex(x, y, z) и грани face(std::span<const int>) с индексами с нуля;
+   * каждая грань ссылается только на уже переданные вершины.
+   *
+   * @throw std::length_error если вершин больше, чем помещается в int.
+   */
+  template <typename Sink>
+  static void generate(const MeshSpec& spec, Sink& sink) {
+    Random random(spec.seed);
+    switch (spec.shape) {
+      case MeshShape::kSphere:
+        sphere(spec.faces, random, sink);
+        break;
+      case MeshShape::kGrid:
+        grid(spec.faces, random, sink);
+        break;
+      case MeshShape::kTorus:
+        torus(spec.faces, random, sink);
+        break;
+      case MeshShape::kSoup:
+        soup(spec.faces, random, sink);
+        break;
+    }
+  }
+
+  /**
+   * @brief Модель в памяти.
+   */
+  static Model3D model(const MeshSpec& spec) {
+    Model3D result;
+    ModelSink sink{result};
+    generate(spec, sink);
+    return result;
+  }
+
+  /**
+   * @brief Текст OBJ-файла модели.
+   */
+  static std::string objText(const MeshSpec& spec,
+                             ObjIndexStyle style = ObjIndexStyle::kPositive) {
+    std::string text;
+    ObjWriter writer(text, style);
+    writer.comment(describe(spec));
+    generate(spec, writer);
+    return text;
+  }
+
+  /**
+   * @brief Записывает модель в OBJ-файл потоково.
+   * @return false если файл не удалось открыть или записать.
+   */
+  static bool writeObj(const MeshSpec& spec, const std::string& filename,
+                       ObjIndexStyle style = ObjIndexStyle::kPositive) {
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) return false;
+    bool ok = false;
+    try {
+      ObjWriter writer(file, style);
+      writer.comment(describe(spec));
+      generate(spec, writer);
+      ok = writer.finish();
+    } catch (...) {
+      std::fclose(file);
+      throw;
+    }
+    return std::fclose(file) == 0 && ok;
+  }
+
+  /**
+   * @brief Форма по имени (sphere, grid, torus, soup).
+   * @return false если имя неизвестно.
+   */
+  static bool parseShape(std::string_view name, MeshShape& shape) {
+    for (MeshShape candidate : {MeshShape::kSphere, MeshShape::kGrid,
+                                MeshShape::kTorus, MeshShape::kSoup}) {
+      if (name == shapeName(candidate)) {
+        shape = candidate;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static const char* shapeName(MeshShape shape) {
+    switch (shape) {
+      case MeshShape::kSphere:
+        return "sphere";
+      case MeshShape::kGrid:
+        return "grid";
+      case MeshShape::kTorus:
+        return "torus";
+      case MeshShape::kSoup:
+        return "soup";
+    }
+    return "";
+  }
+
+  /**
+   * @brief Описание параметров для комментария в начале OBJ-файла.
+   */
+  static std::string describe(const MeshSpec& spec) {
+    return std::string("3DViewerMeshGen shape=") + shapeName(spec.shape) +
+           " faces=" + std::to_string(spec.faces) +
+           " seed=" + std::to_string(spec.seed);
+  }
+
+ private:
+  /**
+   * @brief Генератор SplitMix64: одинаковая последовательность на всех
+   * платформах.
+   */
+  class Random {
+   public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+      uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+    }
+
+    /**
+     * @brief Число в [0, 1) с 24 значащими битами.
+     */
+    float unit() { return static_cast<float>(next() >> 40) * 0x1p-24f; }
+
+    /**
+     * @brief Число в [-1, 1).
+     */
+    float symmetric() { return unit() * 2.0f - 1.0f; }
+
+    /**
+     * @brief Целое в [0, bound).
+     */
+    uint64_t below(uint64_t bound) { return next() % bound; }
+
+   private:
+    uint64_t state_;
+  };
+
+  /**
+   * @brief Приёмник, собирающий модель в Model3D.
+   */
+  struct ModelSink {
+    Model3D& model;
+
+    void reserve(size_t vertices, size_t faces, size_t indices) {
+      model.vertices.reserve(model.vertices.size() + vertices);
+      model.polygons.reserve(model.polygons.size() + faces,
+                             model.polygons.indexCount() + indices);
+    }
+    void vertex(float x, float y, float z) {
+      model.addVertex(Vertex(x, y, z));
+    }
+    void face(std::span<const int> indices) { model.addPolygon(indices); }
+  };
+
+  static constexpr float kJitter =
+      0.002f;  ///< Случайное смещение вершин гладких форм
+
+  /**
+   * @brief Проверяет, что count вершин можно адресовать индексом int.
+   */
+  static void checkVertexCount(size_t count) {
+    if (count > static_cast<size_t>(INT_MAX)) {
+      throw std::length_error("Too many vertices for a synthetic mesh");
+    }
+  }
+
+  /**
+   * @brief Наименьшее n >= minimum, при котором scale * n * n примерно
+   * равно faces.
+   */
+  static size_t sideFor(size_t faces, double scale, size_t minimum) {
+    double side = std::round(std::sqrt(static_cast<double>(faces) / scale));
+    return std::max(minimum, static_cast<size_t>(side));
+  }
+
+  /**
+   * @brief Сфера радиуса 1: rings колец, 2 * rings сегментов, всего
+   * 2 * rings^2 граней. Каждая вершина сдвигается по радиусу на kJitter.
+   */
+  template <typename Sink>
+  static void sphere(size_t faces, Random& random, Sink& sink) {
+    size_t rings = sideFor(faces, 2.0, 3);
+    size_t segments = 2 * rings;
+    size_t vertexCount = 2 + (rings - 1) * segments;
+    checkVertexCount(vertexCount);
+    sink.reserve(vertexCount, rings * segments,
+                 segments * (6 + 4 * (rings - 2)));
+
+    auto point = [&](double theta, double phi) {
+      double radius = 1.0 + kJitter * random.symmetric();
+      sink.vertex(static_cast<float>(radius * std::sin(theta) * std::cos(phi)),
+                  static_cast<float>(radius * std::sin(theta) * std::sin(phi)),
+                  static_cast<float>(radius * std::cos(theta)));
+    };
+    point(0.0, 0.0);
+    for (size_t r = 1; r < rings; ++r) {
+      for (size_t s = 0; s < segments; ++s) {
+        point(M_PI * r / rings, 2.0 * M_PI * s / segments);
+      }
+    }
+    point(M_PI, 0.0);
+
+    int last = static_cast<int>(vertexCount - 1);
+    auto ring = [&](size_t r, size_t s) {
+      return static_cast<int>(1 + (r - 1) * segments + s % segments);
+    };
+    for (size_t s = 0; s < segments; ++s) {
+      const int top[3] = {0, ring(1, s), ring(1, s + 1)};
+      sink.face(top);
+    }
+    for (size_t r = 1; r + 1 < rings; ++r) {
+      for (size_t s = 0; s < segments; ++s) {
+        const int quad[4] = {ring(r, s), ring(r + 1, s), ring(r + 1, s + 1),
+                             ring(r, s + 1)};
+        sink.face(quad);
+      }
+    }
+    for (size_t s = 0; s < segments; ++s) {
+      const int bottom[3] = {last, ring(rings - 1, s + 1),
+                             ring(rings - 1, s)};
+      sink.face(bottom);
+    }
+  }
+
+  /**
+   * @brief Сетка side x side четырёхугольников с волнистым рельефом,
+   * фаза волн зависит от зерна.
+   */
+  template <typename Sink>
+  static void grid(size_t faces, Random& random, Sink& sink) {
+    size_t side = sideFor(faces, 1.0, 1);
+    size_t columns = side + 1;
+    checkVertexCount(columns * columns);
+    sink.reserve(columns * columns, side * side, side * side * 4);
+
+    float phaseX = random.unit() * 6.0f, phaseY = random.unit() * 6.0f;
+    float step = 2.0f / static_cast<float>(side);
+    for (size_t row = 0; row < columns; ++row) {
+      for (size_t col = 0; col < columns; ++col) {
+        float x = -1.0f + step * col, y = -1.0f + step * row;
+        float height = 0.1f * std::sin(4.0f * x + phaseX) *
+                           std::cos(4.0f * y + phaseY) +
+                       kJitter * random.symmetric();
+        sink.vertex(x, y, height);
+      }
+    }
+    for (size_t row = 0; row < side; ++row) {
+      for (size_t col = 0; col < side; ++col) {
+        int v = static_cast<int>(row * columns + col);
+        int next = v + static_cast<int>(columns);
+        const int quad[4] = {v, v + 1, next + 1, next};
+        sink.face(quad);
+      }
+    }
+  }
+
+  /**
+   * @brief Тор с радиусами 1 и 0.3: 2 * minor сегментов по большой
+   * окружности и minor по малой, всего 2 * minor^2 граней.
+   */
+  template <typename Sink>
+  static void torus(size_t faces, Random& random, Sink& sink) {
+    size_t minor = sideFor(faces, 2.0, 3);
+    size_t major = 2 * minor;
+    checkVertexCount(major * minor);
+    sink.reserve(major * minor, major * minor, major * minor * 4);
+
+    for (size_t i = 0; i < major; ++i) {
+      double u = 2.0 * M_PI * i / major;
+      for (size_t j = 0; j < minor; ++j) {
+        double v = 2.0 * M_PI * j / minor;
+        double tube = 0.3 + kJitter * random.symmetric();
+        double radius = 1.0 + tube * std::cos(v);
+        sink.vertex(static_cast<float>(radius * std::cos(u)),
+                    static_cast<float>(radius * std::sin(u)),
+                    static_cast<float>(tube * std::sin(v)));
+      }
+    }
+    auto at = [&](size_t i, size_t j) {
+      return static_cast<int>((i % major) * minor + j % minor);
+    };
+    for (size_t i = 0; i < major; ++i) {
+      for (size_t j = 0; j < minor; ++j) {
+        const int quad[4] = {at(i, j), at(i + 1, j), at(i + 1, j + 1),
+                             at(i, j + 1)};
+        sink.face(quad);
+      }
+    }
+  }
+
+  /**
+   * @brief Ровно faces случайных граней: 45% треугольников, 35%
+   * четырёхугольников, остальные — от 5 до 8 вершин.
+   *
+   * Вершины грани лежат рядом со случайной точкой куба [-1, 1]^3; каждая
+   * четвёртая в среднем вершина берётся из уже созданных, так что грани
+   * ссылаются и на соседние, и на далёкие вершины файла.
+   */
+  template <typename Sink>
+  static void soup(size_t faces, Random& random, Sink& sink) {
+    sink.reserve(faces * 3, faces, faces * 4);
+    size_t vertexCount = 0;
+    int corners[8];
+    for (size_t f = 0; f < faces; ++f) {
+      uint64_t kind = random.below(100);
+      int size = kind < 45 ? 3 : kind < 80 ? 4 : 5 + int(random.below(4));
+      float cx = random.symmetric(), cy = random.symmetric(),
+            cz = random.symmetric();
+      for (int k = 0; k < size; ++k) {
+        if (vertexCount > 0 && random.below(4) == 0) {
+          corners[k] = static_cast<int>(random.below(vertexCount));
+          continue;
+        }
+        checkVertexCount(vertexCount + 1);
+        sink.vertex(cx + 0.02f * random.symmetric(),
+                    cy + 0.02f * random.symmetric(),
+                    cz + 0.02f * random.symmetric());
+        corners[k] = static_cast<int>(vertexCount++);
+      }
+      sink.face(std::span<const int>(corners, size));
+    }
+  }
+};  // class MeshGenerator
+
+}  // namespace s21
+
+#endif  // MESH_GENERATOR_H
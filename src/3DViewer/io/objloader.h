@@ -6,14 +6,57 @@
 #ifndef OBJ_LOADER_H
 #define OBJ_LOADER_H
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #include "../core/model3d.h"
+#include "../core/threadpool.h"
+#include "mappedfile.h"
+#include "objtokenizer.h"
 
 namespace s21 {
 
+/**
+ * @brief Параметры управления разбором: прогресс и отмена.
+ */
+struct ParseControl {
+  /**
+   * @brief Вызывается по мере разбора с числом обработанных байтов и общим
+   * размером данных. При параллельном разборе может вызываться из рабочих
+   * потоков.
+   */
+  std::function<void(size_t consumed, size_t total)> onProgress;
+
+  /**
+   * @brief Флаг отмены. Если установлен, разбор прекращается, а модель
+   * остаётся в неопределённом состоянии.
+   */
+  const std::atomic<bool>* cancelled = nullptr;
+
+  /**
+   * @brief Вызывается по мере разбора с частично загруженной моделью и
+   * числом байтов от начала данных, уже вошедших в неё. Вершины и грани
+   * добавляются только в конец, поэтому новыми считаются элементы после уже
+   * обработанных вызывающим кодом.
+   *
+   * parseObj() вызывает его после каждого отчёта о прогрессе и в конце
+   * разбора. parseObjParallel() — после присоединения к модели очередных
+   * готовых частей в порядке файла; вызов идёт из рабочего потока, но
+   * никогда не одновременно с другим вызовом.
+   */
+  std::function<void(const Model3D& model, size_t consumed, size_t total)>
+      onBatch;
+};
+
 /**
  * @brief Класс, реализующий загрузку моделей из .obj файлов.
  */
@@ -66,6 +109,449 @@ class ObjParser {
     file.close();
     return true;
   }
+
+  /**
+   * @brief Загружает модель из OBJ-файла, отображённого в память.
+   *
+   * Разбирает данные прямо из отображения через std::string_view без
+   * построчных выделений памяти. Если отобразить файл не удалось, он
+   * читается в буфер целиком.
+   *
+   * @param filename Имя файла
+   * @param model Ссылка на объект модели для загрузки
+   * @param control Прогресс и отмена (может быть nullptr)
+   * @return true если загрузка успешна, false — в случае ошибки или отмены
+   */
+  static bool loadObjMapped(const std::string& filename, Model3D& model,
+                            const ParseControl* control = nullptr) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+      std::cerr << "Error: Cannot open file " << filename << "\n";
+      return false;
+    }
+
+    return parseObj(file.view(), model, control);
+  }
+
+  /**
+   * @brief Разбирает содержимое OBJ-файла из памяти.
+   *
+   * Если в control задан onBatch, частично загруженная модель передаётся
+   * ему по мере разбора, что позволяет показывать модель до завершения
+   * загрузки.
+   *
+   * @param data Текст OBJ-файла
+   * @param model Ссылка на объект модели для загрузки
+   * @param control Прогресс и отмена (может быть nullptr)
+   * @return false если разбор был отменён
+   * @throw std::invalid_argument если индекс вершины грани не число.
+   * @throw std::out_of_range если индекс вершины грани недопустим.
+   */
+  static bool parseObj(std::string_view data, Model3D& model,
+                       const ParseControl* control = nullptr) {
+    ParseProgress progress(control, data.size());
+    std::vector<int> vertexIndices;  // Переиспользуется для всех граней
+    size_t pos = 0;
+    size_t pending = 0;
+    while (pos < data.size()) {
+      size_t end = ObjTokenizer::findLineEnd(data, pos);
+      parseLine(data.substr(pos, end - pos), model, vertexIndices);
+      pending += end + 1 - pos;
+      pos = end + 1;
+      if (pending >= kProgressStep) {
+        if (!progress.advance(pending)) return false;
+        if (control && control->onBatch) {
+          control->onBatch(model, std::min(pos, data.size()), data.size());
+        }
+        pending = 0;
+      }
+    }
+    if (!progress.advance(pending)) return false;
+    if (control && control->onBatch) {
+      control->onBatch(model, data.size(), data.size());
+    }
+    return true;
+  }
+
+  /**
+   * @brief Загружает модель из OBJ-файла, разбирая его в нескольких потоках.
+   *
+   * Файл отображается в память так же, как в loadObjMapped(), и делится на
+   * части по границам строк (см. parseObjParallel()).
+   *
+   * @param filename Имя файла
+   * @param model Ссылка на объект модели для загрузки
+   * @param threadCount Число потоков (0 — все потоки ThreadPool)
+   * @param control Прогресс и отмена (может быть nullptr)
+   * @return true если загрузка успешна, false — в случае ошибки или отмены
+   */
+  static bool loadObjParallel(const std::string& filename, Model3D& model,
+                              unsigned threadCount = 0,
+                              const ParseControl* control = nullptr) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+      std::cerr << "Error: Cannot open file " << filename << "\n";
+      return false;
+    }
+
+    return parseObjParallel(file.view(), model, threadCount, kMinChunkSize,
+                            control);
+  }
+
+  /**
+   * @brief Разбирает содержимое OBJ-файла в нескольких потоках.
+   *
+   * Данные делятся на части, выровненные по переводу строки; части
+   * разбираются потоками общего ThreadPool. Вершины и грани каждой части
+   * складываются в отдельный буфер, после чего буферы объединяются в
+   * модель в порядке следования в файле.
+   * Отрицательные индексы разрешаются относительно начала части и
+   * сдвигаются на число вершин предыдущих частей при объединении, поэтому
+   * результат совпадает с parseObj().
+   *
+   * Если в control задан onBatch, части не меньше kStreamChunkSize берутся
+   * потоками по порядку и присоединяются к модели, как только готово всё
+   * начало файла до них; после каждого присоединения модель передаётся
+   * onBatch. Так большой файл разбирается параллельно и при этом
+   * показывается по мере загрузки.
+   *
+   * @param data Текст OBJ-файла
+   * @param model Ссылка на объект модели для загрузки
+   * @param threadCount Число потоков (0 — все потоки ThreadPool)
+   * @param minChunkSize Минимальный размер части в байтах
+   * @param control Прогресс и отмена (может быть nullptr)
+   * @return false если разбор был отменён
+   * @throw std::invalid_argument если индекс вершины грани не число.
+   * @throw std::out_of_range если индекс вершины грани недопустим.
+   */
+  static bool parseObjParallel(std::string_view data, Model3D& model,
+                               unsigned threadCount = 0,
+                               size_t minChunkSize = kMinChunkSize,
+                               const ParseControl* control = nullptr) {
+    if (threadCount == 0) threadCount = ThreadPool::instance().concurrency();
+    size_t chunkCount = std::min<size_t>(
+        threadCount, std::max<size_t>(1, data.size() / minChunkSize));
+    if (chunkCount <= 1) return parseObj(data, model, control);
+    if (control && control->onBatch) {
+      // Частей больше, чем потоков, чтобы начало файла публиковалось рано
+      size_t streamCount = std::max(
+          chunkCount, std::min(data.size() / minChunkSize,
+                               data.size() / kStreamChunkSize));
+      return parseStreamed(data, splitLines(data, streamCount), model,
+                           threadCount, control);
+    }
+
+    std::vector<std::string_view> parts = splitLines(data, chunkCount);
+    ParseProgress progress(control, data.size());
+    std::vector<ObjChunk> chunks(parts.size());
+    ThreadPool::instance().parallelFor(
+        parts.size(), 1,
+        [&](size_t first, size_t last) {
+          for (size_t i = first; i < last; ++i) {
+            parseChunk(parts[i], chunks[i], progress);
+          }
+        },
+        threadCount);
+
+    if (progress.cancelled()) return false;
+    mergeChunks(chunks, model);
+    return true;
+  }
+
+  static constexpr size_t kMinChunkSize =
+      1 << 20;  ///< Минимальный размер части для параллельного разбора
+  static constexpr size_t kProgressStep =
+      1 << 20;  ///< Шаг в байтах между отчётами о прогрессе
+  static constexpr size_t kStreamChunkSize =
+      4 << 20;  ///< Размер части при параллельном разборе с публикацией
+  static constexpr double kReserveSlack =
+      1.125;  ///< Запас при резервировании модели по оценке из начала файла
+
+ private:
+  /**
+   * @brief Счётчик обработанных байтов, общий для всех потоков разбора.
+   */
+  class ParseProgress {
+   public:
+    ParseProgress(const ParseControl* control, size_t total)
+        : control_(control), total_(total) {}
+
+    /**
+     * @brief Проверяет, запрошена ли отмена.
+     */
+    bool cancelled() const {
+      return control_ && control_->cancelled &&
+             control_->cancelled->load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Учитывает обработанные байты и сообщает о прогрессе.
+     * @return false если разбор нужно прекратить.
+     */
+    bool advance(size_t bytes) {
+      if (!control_) return true;
+      size_t consumed =
+          consumed_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+      if (control_->onProgress) {
+        control_->onProgress(std::min(consumed, total_), total_);
+      }
+      return !cancelled();
+    }
+
+   private:
+    const ParseControl* control_;
+    size_t total_;
+    std::atomic<size_t> consumed_{0};
+  };
+
+  /**
+   * @brief Результат разбора одной части файла.
+   *
+   * Индексы граней хранятся подряд; положительные индексы уже абсолютные,
+   * отрицательные — разрешены относительно начала части, их позиции
+   * перечислены в relativeSlots.
+   */
+  struct ObjChunk {
+    std::vector<Vertex> vertices;
+    std::vector<int> indices;
+    std::vector<size_t> polygonSizes;
+    std::vector<size_t> relativeSlots;
+    long long minAbsolute = LLONG_MAX;  ///< Минимальный абсолютный индекс
+    long long maxForward = LLONG_MIN;  ///< max(индекс - число вершин части)
+    long long minRelative = LLONG_MAX;  ///< Минимальный относительный индекс
+    std::exception_ptr error;
+  };
+
+  /**
+   * @brief Делит данные на chunkCount частей, выровненных по переводу
+   * строки.
+   */
+  static std::vector<std::string_view> splitLines(std::string_view data,
+                                                  size_t chunkCount) {
+    std::vector<std::string_view> parts;
+    size_t begin = 0;
+    for (size_t i = 1; i <= chunkCount && begin < data.size(); ++i) {
+      size_t end = data.size() * i / chunkCount;
+      if (end < begin) end = begin;
+      if (i < chunkCount) {
+        end = ObjTokenizer::findLineEnd(data, end);
+        if (end < data.size()) ++end;
+      }
+      parts.push_back(data.substr(begin, end - begin));
+      begin = end;
+    }
+    return parts;
+  }
+
+  /**
+   * @brief Параллельный разбор с публикацией готового начала файла
+   * (см. parseObjParallel()).
+   *
+   * Потоки берут части по возрастанию номера. Поток, закончивший первую
+   * неприсоединённую часть, под блокировкой присоединяет её и все готовые
+   * следующие части к модели и вызывает onBatch; остальные потоки только
+   * отмечают свою часть готовой и берут следующую.
+   */
+  static bool parseStreamed(std::string_view data,
+                            const std::vector<std::string_view>& parts,
+                            Model3D& model, unsigned threadCount,
+                            const ParseControl* control) {
+    ParseProgress progress(control, data.size());
+    std::vector<ObjChunk> chunks(parts.size());
+    std::vector<char> parsed(parts.size(), false);  // Под mutex
+    std::mutex mutex;
+    size_t merged = 0;       // Присоединённые части (под mutex)
+    size_t mergedBytes = 0;  // Их размер в байтах (под mutex)
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+
+    auto publish = [&]() {
+      size_t first = merged;
+      while (merged < parts.size() && parsed[merged] &&
+             !progress.cancelled()) {
+        ObjChunk& chunk = chunks[merged];
+        if (merged == 0 && !parts[0].empty()) {
+          // Оценка размера модели по доле файла в первой части
+          double scale = kReserveSlack * static_cast<double>(data.size()) /
+                         static_cast<double>(parts[0].size());
+          model.vertices.reserve(
+              static_cast<size_t>(scale * chunk.vertices.size()));
+          model.polygons.reserve(
+              static_cast<size_t>(scale * chunk.polygonSizes.size()),
+              static_cast<size_t>(scale * chunk.indices.size()));
+        }
+        long long base = static_cast<long long>(model.vertices.size());
+        checkChunk(chunk, base);
+        appendChunk(chunk, base, model);
+        mergedBytes += parts[merged].size();
+        ++merged;
+      }
+      if (merged != first) control->onBatch(model, mergedBytes, data.size());
+    };
+
+    ThreadPool::instance().parallelFor(
+        threadCount, 1,
+        [&](size_t, size_t) {
+          for (size_t i = next++; i < parts.size() && !failed; i = next++) {
+            parseChunk(parts[i], chunks[i], progress);
+            std::lock_guard<std::mutex> lock(mutex);
+            parsed[i] = true;
+            if (i != merged) continue;  // Начало файла ещё не готово
+            try {
+              publish();
+            } catch (...) {
+              failed = true;
+              throw;
+            }
+          }
+        },
+        threadCount);
+
+    return !progress.cancelled();
+  }
+
+  /**
+   * @brief Разбирает одну часть файла в собственный буфер.
+   */
+  static void parseChunk(std::string_view data, ObjChunk& chunk,
+                         ParseProgress& progress) {
+    try {
+      size_t pos = 0;
+      size_t pending = 0;
+      while (pos < data.size()) {
+        size_t end = ObjTokenizer::findLineEnd(data, pos);
+        std::string_view line = data.substr(pos, end - pos);
+        pending += end + 1 - pos;
+        pos = end + 1;
+        if (pending >= kProgressStep) {
+          if (!progress.advance(pending)) return;
+          pending = 0;
+        }
+
+        std::string_view type = ObjTokenizer::nextToken(line);
+        if (type == "v") {
+          float x = ObjTokenizer::parseFloat(ObjTokenizer::nextToken(line));
+          float y = ObjTokenizer::parseFloat(ObjTokenizer::nextToken(line));
+          float z = ObjTokenizer::parseFloat(ObjTokenizer::nextToken(line));
+          chunk.vertices.emplace_back(x, y, z);
+        } else if (type == "f") {
+          long long localCount = static_cast<long long>(chunk.vertices.size());
+          size_t count = 0;
+          for (std::string_view token = ObjTokenizer::nextToken(line);
+               !token.empty();
+               token = ObjTokenizer::nextToken(line), ++count) {
+            long long vertexIndex = ObjTokenizer::parseIndexTriplet(token).v;
+            if (vertexIndex < 0) {
+              vertexIndex += localCount;
+              chunk.minRelative = std::min(chunk.minRelative, vertexIndex);
+              chunk.relativeSlots.push_back(chunk.indices.size());
+            } else {
+              vertexIndex -= 1;
+              chunk.minAbsolute = std::min(chunk.minAbsolute, vertexIndex);
+              chunk.maxForward =
+                  std::max(chunk.maxForward, vertexIndex - localCount);
+            }
+            chunk.indices.push_back(static_cast<int>(vertexIndex));
+          }
+          chunk.polygonSizes.push_back(count);
+        }
+      }
+      progress.advance(pending);
+    } catch (...) {
+      chunk.error = std::current_exception();
+    }
+  }
+
+  /**
+   * @brief Объединяет части в модель в порядке следования в файле.
+   * @throw std::out_of_range если индекс вершины грани недопустим.
+   */
+  static void mergeChunks(std::vector<ObjChunk>& chunks, Model3D& model) {
+    // Проверяем индексы до изменения модели
+    long long base = static_cast<long long>(model.vertices.size());
+    std::vector<long long> bases;
+    bases.reserve(chunks.size());
+    size_t vertexTotal = 0;
+    size_t polygonTotal = 0;
+    size_t indexTotal = 0;
+    for (const auto& chunk : chunks) {
+      checkChunk(chunk, base);
+      bases.push_back(base);
+      base += static_cast<long long>(chunk.vertices.size());
+      vertexTotal += chunk.vertices.size();
+      polygonTotal += chunk.polygonSizes.size();
+      indexTotal += chunk.indices.size();
+    }
+
+    model.vertices.reserve(model.vertices.size() + vertexTotal);
+    model.polygons.reserve(model.polygons.size() + polygonTotal,
+                           model.polygons.indexCount() + indexTotal);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      appendChunk(chunks[i], bases[i], model);
+    }
+  }
+
+  /**
+   * @brief Проверяет часть, которая будет присоединена после base вершин.
+   * @throw std::out_of_range если индекс вершины грани недопустим.
+   */
+  static void checkChunk(const ObjChunk& chunk, long long base) {
+    if (chunk.error) std::rethrow_exception(chunk.error);
+    if (chunk.minAbsolute < 0 || chunk.maxForward >= base ||
+        (chunk.minRelative != LLONG_MAX && chunk.minRelative + base < 0) ||
+        base + static_cast<long long>(chunk.vertices.size()) > INT_MAX) {
+      throw std::out_of_range("Invalid vertex index in polygon");
+    }
+  }
+
+  /**
+   * @brief Дописывает проверенную часть в модель после base вершин и
+   * освобождает её память.
+   */
+  static void appendChunk(ObjChunk& chunk, long long base, Model3D& model) {
+    model.vertices.insert(model.vertices.end(), chunk.vertices.begin(),
+                          chunk.vertices.end());
+    for (size_t slot : chunk.relativeSlots) {
+      chunk.indices[slot] += static_cast<int>(base);
+    }
+
+    const int* first = chunk.indices.data();
+    for (size_t size : chunk.polygonSizes) {
+      model.polygons.push_back(std::span<const int>(first, size));
+      first += size;
+    }
+    chunk = ObjChunk();  // Освобождаем память части
+  }
+
+  /**
+   * @brief Разбирает одну строку OBJ-файла.
+   */
+  static void parseLine(std::string_view line, Model3D& model,
+                        std::vector<int>& vertexIndices) {
+    std::string_view type = ObjTokenizer::nextToken(line);
+
+    if (type == "v") {  // Вершина
+      float x = ObjTokenizer::parseFloat(ObjTokenizer::nextToken(line));
+      float y = ObjTokenizer::parseFloat(ObjTokenizer::nextToken(line));
+      float z = ObjTokenizer::parseFloat(ObjTokenizer::nextToken(line));
+      model.addVertex(Vertex(x, y, z));
+    } else if (type == "f") {  // Полигон
+      vertexIndices.clear();
+      for (std::string_view token = ObjTokenizer::nextToken(line);
+           !token.empty(); token = ObjTokenizer::nextToken(line)) {
+        // Берем только первую часть v/vt/vn
+        int vertexIndex = ObjTokenizer::parseIndexTriplet(token).v;
+
+        // Преобразуем индексацию с 1 в индексацию с 0
+        if (vertexIndex < 0) {
+          vertexIndex += model.vertices.size() + 1;  // Отрицательные индексы
+        }
+        vertexIndices.push_back(vertexIndex - 1);
+      }
+      model.addPolygon(std::span<const int>(vertexIndices));
+    }
+    // Игнорируем другие команды (например, vn, vt)
+  }
 };  // class ObjParser
 
 }  // namespace s21
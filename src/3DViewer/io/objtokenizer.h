@@ -0,0 +1,258 @@
+/**
+ * @file objtokenizer.h
+ * @brief Класс ObjTokenizer — поиск границ строк и полей OBJ-файла и
+ * разбор числовых значений.
+ */
+
+#ifndef OBJ_TOKENIZER_H
+#define OBJ_TOKENIZER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#include "../core/simd.h"
+
+namespace s21 {
+
+/**
+ * @brief Индексы одной вершины грани в формате v/vt/vn.
+ *
+ * Отсутствующие компоненты (например, vt в записи "1//3") равны 0.
+ */
+struct IndexTriplet {
+  int v = 0;
+  int vt = 0;
+  int vn = 0;
+};
+
+/**
+ * @class ObjTokenizer
+ * @brief Ядро разбора OBJ-файла: поиск переводов строк и разделителей полей
+ * с помощью SSE2/AVX2 и разбор чисел без учёта локали.
+ *
+ * Разделителем полей считается любой байт не больше пробела (' ', '\t',
+ * '\r', '\v', '\f'). Набор инструкций выбирается при первом обращении
+ * по возможностям процессора, для остальных архитектур используется
+ * скалярная реализация.
+ */
+class ObjTokenizer {
+ public:
+  /**
+   * @brief Набор инструкций, используемый для поиска границ.
+   */
+  using Isa = SimdIsa;
+
+  /**
+   * @brief Возвращает выбранный набор инструкций.
+   *
+   * Значение можно изменить (например, в тестах), чтобы принудительно
+   * использовать другую реализацию; делать это нужно до начала разбора.
+   */
+  static Isa& isa() {
+    static Isa selected = detectIsa();
+    return selected;
+  }
+
+  /**
+   * @brief Определяет лучший набор инструкций, доступный процессору.
+   */
+  static Isa detectIsa() { return detectSimdIsa(); }
+
+  /**
+   * @brief Ищет позицию перевода строки начиная с pos.
+   * @return Позиция '\n' или размер данных, если перевода строки нет.
+   */
+  static size_t findLineEnd(std::string_view data, size_t pos) {
+    const char* first = data.data() + pos;
+    const char* last = data.data() + data.size();
+    return static_cast<size_t>(findNewline(first, last) - data.data());
+  }
+
+  /**
+   * @brief Извлекает следующее поле строки и сдвигает начало строки за него.
+   * @return Пустой view, если полей больше нет.
+   */
+  static std::string_view nextToken(std::string_view& line) {
+    const char* last = line.data() + line.size();
+    const char* begin = skipSpaces(line.data(), last);
+    const char* end = findSpace(begin, last);
+    line = std::string_view(end, static_cast<size_t>(last - end));
+    return std::string_view(begin, static_cast<size_t>(end - begin));
+  }
+
+  /**
+   * @brief Преобразует поле в число с плавающей точкой через std::from_chars.
+   * @return 0, если поле не является числом (как при чтении из потока).
+   */
+  static float parseFloat(std::string_view token) {
+    if (!token.empty() && token.front() == '+') token.remove_prefix(1);
+    float value = 0.0f;
+    auto result =
+        std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ec != std::errc()) value = 0.0f;
+    return value;
+  }
+
+  /**
+   * @brief Разбирает целое число со знаком в начале поля.
+   *
+   * Поведение совпадает с std::stoi: разбор останавливается на первом
+   * нецифровом символе.
+   *
+   * @param token Поле; после вызова указывает на остаток за числом.
+   * @throw std::invalid_argument если поле не начинается с числа.
+   * @throw std::out_of_range если число не помещается в int.
+   */
+  static int parseInt(std::string_view& token) {
+    const char* p = token.data();
+    const char* last = p + token.size();
+    bool negative = false;
+    if (p != last && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+    const char* digits = p;
+    unsigned long long value = 0;
+    const unsigned long long limit =
+        negative ? 2147483648ULL : 2147483647ULL;  // |INT_MIN|, INT_MAX
+    while (p != last && static_cast<unsigned char>(*p - '0') < 10) {
+      value = value * 10 + static_cast<unsigned>(*p - '0');
+      if (value > limit) throw std::out_of_range("Vertex index out of range");
+      ++p;
+    }
+    if (p == digits) throw std::invalid_argument("Invalid vertex index");
+
+    token.remove_prefix(static_cast<size_t>(p - token.data()));
+    return negative ? static_cast<int>(-static_cast<long long>(value))
+                    : static_cast<int>(value);
+  }
+
+  /**
+   * @brief Разбирает поле грани вида v, v/vt, v//vn или v/vt/vn.
+   * @throw std::invalid_argument если индекс вершины не число.
+   * @throw std::out_of_range если индекс не помещается в int.
+   */
+  static IndexTriplet parseIndexTriplet(std::string_view token) {
+    IndexTriplet triplet;
+    triplet.v = parseInt(token);
+    if (!token.empty() && token.front() == '/') {
+      token.remove_prefix(1);
+      if (!token.empty() && token.front() != '/') triplet.vt = parseInt(token);
+      if (!token.empty() && token.front() == '/') {
+        token.remove_prefix(1);
+        if (!token.empty()) triplet.vn = parseInt(token);
+      }
+    }
+    return triplet;
+  }
+
+  /**
+   * @brief Возвращает true для байтов-разделителей полей.
+   */
+  static bool isSpace(char c) { return static_cast<unsigned char>(c) <= ' '; }
+
+ private:
+  /**
+   * @brief Ищет '\n' в диапазоне [first, last).
+   */
+  static const char* findNewline(const char* first, const char* last) {
+    switch (isa()) {
+#if S21_HAS_AVX2
+      case Isa::kAvx2:
+        return findNewlineAvx2(first, last);
+#endif
+#if S21_HAS_SSE2
+      case Isa::kSse2:
+        return findNewlineSse2(first, last);
+#endif
+      default:
+        return findNewlineScalar(first, last);
+    }
+  }
+
+  /**
+   * @brief Пропускает разделители в диапазоне [first, last).
+   */
+  static const char* skipSpaces(const char* first, const char* last) {
+#if S21_HAS_SSE2
+    if (isa() != Isa::kScalar) {
+      const __m128i space = _mm_set1_epi8(' ');
+      while (last - first >= 16) {
+        __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        // Байт не больше пробела, если max(b, ' ') == ' '
+        __m128i blank = _mm_cmpeq_epi8(_mm_max_epu8(chunk, space), space);
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(blank)) &
+                        0xFFFFu;
+        if (mask != 0) return first + __builtin_ctz(mask);
+        first += 16;
+      }
+    }
+#endif
+    while (first != last && isSpace(*first)) ++first;
+    return first;
+  }
+
+  /**
+   * @brief Ищет первый разделитель в диапазоне [first, last).
+   */
+  static const char* findSpace(const char* first, const char* last) {
+#if S21_HAS_SSE2
+    if (isa() != Isa::kScalar) {
+      const __m128i space = _mm_set1_epi8(' ');
+      while (last - first >= 16) {
+        __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i blank = _mm_cmpeq_epi8(_mm_max_epu8(chunk, space), space);
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(blank));
+        if (mask != 0) return first + __builtin_ctz(mask);
+        first += 16;
+      }
+    }
+#endif
+    while (first != last && !isSpace(*first)) ++first;
+    return first;
+  }
+
+  static const char* findNewlineScalar(const char* first, const char* last) {
+    const void* found =
+        std::memchr(first, '\n', static_cast<size_t>(last - first));
+    return found ? static_cast<const char*>(found) : last;
+  }
+
+#if S21_HAS_SSE2
+  static const char* findNewlineSse2(const char* first, const char* last) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (last - first >= 16) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+      if (mask != 0) return first + __builtin_ctz(static_cast<unsigned>(mask));
+      first += 16;
+    }
+    while (first != last && *first != '\n') ++first;
+    return first;
+  }
+#endif
+
+#if S21_HAS_AVX2
+  S21_TARGET_AVX2
+  static const char* findNewlineAvx2(const char* first, const char* last) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    while (last - first >= 32) {
+      __m256i chunk =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+      unsigned mask = static_cast<unsigned>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+      if (mask != 0) return first + __builtin_ctz(mask);
+      first += 32;
+    }
+    while (first != last && *first != '\n') ++first;
+    return first;
+  }
+#endif
+};  // class ObjTokenizer
+
+}  // namespace s21
+
+#endif  // OBJ_TOKENIZER_H
@@ -26,6 +26,55 @@ Window {
         // Переключатель проекции
         property bool perspectiveProjection: true
 
+        // Уровень детализации выбирается по размеру модели на экране,
+        // кластеры рёбер вне поля зрения камеры скрываются
+        function updateLod() {
+            var camera = appSettings.isPerspective ? perspectiveCamera : orthographicCamera;
+            var fieldOfView = appSettings.isPerspective ? perspectiveCamera.fieldOfView : 0;
+            facade.updateLod(scaleSlider.value, camera.position.length(),
+                             fieldOfView, view3d.height);
+            facade.updateCulling(camera.scenePosition, camera.sceneRotation,
+                                 fieldOfView, view3d.width, view3d.height);
+        }
+
+        onWidthChanged: updateLod()
+        onHeightChanged: updateLod()
+        Component.onCompleted: {
+            facade.setPickView(view3d);
+            updateLod();
+        }
+
+        // Вершина или ребро под курсором (Facade::pickAt)
+        HoverHandler {
+            onPointChanged: {
+                var pick = facade.pickAt(point.position.x, point.position.y);
+                pickMarker.visible = pick.kind !== "none";
+                if (pick.kind === "vertex") {
+                    pickInfo.text = "Vertex " + pick.vertex;
+                } else if (pick.kind === "edge") {
+                    pickInfo.text = "Edge " + pick.from + " - " + pick.to;
+                } else {
+                    pickInfo.text = "";
+                }
+                if (pickMarker.visible)
+                    pickMarker.position = pick.position;
+            }
+        }
+
+        Text {
+            id: pickInfo
+            anchors.left: parent.left
+            anchors.bottom: parent.bottom
+            anchors.margins: 10
+            font.pixelSize: 12
+            color: appSettings.lineColor
+        }
+
+        Connections {
+            target: appSettings
+            function onSettingsChanged() { view3d.updateLod(); }
+        }
+
         environment: SceneEnvironment {
             id: sceneEnvironment
             clearColor: appSettings.backgroundColor
@@ -63,6 +112,9 @@ Window {
         Model {
             id: linesModel
             scale: Qt.vector3d(100, 100, 100)
+            // Поворот и сдвиг применяются к узлу, вершины не перестраиваются
+            rotation: facade.modelRotation
+            position: facade.modelPosition.times(scale.x)
             materials: principledMaterial
             PrincipledMaterial {
                 id: principledMaterial
@@ -76,13 +128,38 @@ Window {
                 property real gapLength: 0.1
                 property color baseColor: appSettings.lineColor
 
+                vertexShader: "qrc:/shaders/dashed_shader.vert"
                 fragmentShader: "qrc:/shaders/dashed_shader.frag"
             }
+            // Кластеры рёбер большой модели (Facade::setSplitLargeModels);
+            // дочерние узлы наследуют преобразование linesModel
+            Repeater3D {
+                model: facade.lineChunks
+                Model {
+                    geometry: modelData
+                    materials: linesModel.materials
+                    visible: facade.lineChunkVisibility[index] !== false
+                }
+            }
+        }
+
+        // Отметка выбранной вершины или точки ребра
+        Model {
+            id: pickMarker
+            source: "#Sphere"
+            scale: Qt.vector3d(0.05, 0.05, 0.05)
+            visible: false
+            materials: PrincipledMaterial {
+                lighting: PrincipledMaterial.NoLighting
+                baseColor: "#ff7043"
+            }
         }
 
         Model {
             id: verticesModel
             scale: Qt.vector3d(100, 100, 100)
+            rotation: facade.modelRotation
+            position: facade.modelPosition.times(scale.x)
             materials: principledVertexMaterial
             CustomMaterial {
                 id: vertexMaterial
@@ -144,6 +221,15 @@ Window {
                     }
                 }
 
+                // Прогресс фоновой загрузки модели
+                ProgressBar {
+                    id: loadProgressBar
+                    from: 0
+                    to: 1
+                    visible: false
+                    Layout.preferredWidth: 150
+                }
+
                 // Информация о вершинах
                 Rectangle {
                     color: "#FFFFFF"
@@ -239,13 +325,14 @@ Window {
                         // Извлекаем только имя файла из полного пути
                         var fileName = objFilePath.toString().split('/').pop();
                         fileNameText.text = "File: " + fileName;
+                        loadProgressBar.value = 0;
+                        loadProgressBar.visible = true;
+                        // Загрузка идёт в фоне, представления строятся по onModelLoaded
                         facade.loadModel(objFilePath);
                     } else {
                         console.log("No file selected.");
                         fileNameText.text = "File: none";
                     }
-                    verticesModel.geometry = facade.createVerticesView();
-                    linesModel.geometry = facade.createLinesView();
                 }
             }
 
@@ -259,6 +346,34 @@ Window {
                 function onPolygonCountChanged() {
                     polygonInfo.text = "Polygons: " + facade.polygonCount();
                 }
+                // Прогресс загрузки модели
+                function onLoadProgress(progress) {
+                    loadProgressBar.value = progress;
+                }
+                // Модель загружена — строим представления
+                function onModelLoaded() {
+                    loadProgressBar.visible = false;
+                    verticesModel.geometry = facade.createVerticesView();
+                    linesModel.geometry = facade.createLinesView();
+                }
+                // Сменился уровень детализации — берём его представления
+                function onLodChanged() {
+                    verticesModel.geometry = facade.createVerticesView();
+                    linesModel.geometry = facade.createLinesView();
+                }
+                // Первая часть большой модели — показываем её до конца загрузки
+                function onStreamingStarted() {
+                    verticesModel.geometry = null;
+                    linesModel.geometry = facade.streamingView();
+                }
+                function onLoadFailed() {
+                    loadProgressBar.visible = false;
+                    // Убираем недогруженное превью, возвращая прежнюю модель
+                    if (facade.streamingView()) {
+                        verticesModel.geometry = facade.createVerticesView();
+                        linesModel.geometry = facade.createLinesView();
+                    }
+                }
             }
         }
     }
@@ -803,10 +918,10 @@ Window {
                     id: scaleDebounceTimer
                     interval: 100
                     onTriggered: {
+                        // Масштаб задаётся узлам, геометрия не перестраивается
                         linesModel.scale = Qt.vector3d(scaleSlider.value, scaleSlider.value, scaleSlider.value);
                         verticesModel.scale = Qt.vector3d(scaleSlider.value, scaleSlider.value, scaleSlider.value);
-                        linesModel.geometry = facade.createLinesView();
-                        verticesModel.geometry = facade.createVerticesView();
+                        view3d.updateLod();
                     }
                 }
 
@@ -816,13 +931,5 @@ Window {
                 }
             }
         }
-
-        Connections {
-            target: facade
-            function onGeometryUpdated() {
-                linesModel.geometry = facade.createLinesView();
-                verticesModel.geometry = facade.createVerticesView();
-            }
-        }
     }
 }
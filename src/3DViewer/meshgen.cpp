@@ -0,0 +1,80 @@
+/**
+ * @file meshgen.cpp
+ * @brief 3DViewerMeshGen — запись синтетических моделей в OBJ-файлы.
+ *
+ * Использование:
+ * @code
+ * 3DViewerMeshGen [--shape sphere|grid|torus|soup] [--faces N] [--seed S]
+ *                 [--indices positive|negative|mixed] output.obj
+ * @endcode
+ * Модель записывается потоково (MeshGenerator::writeObj()), поэтому размер
+ * ограничен только диском; при одном зерне файл получается тем же.
+ */
+
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "io/meshgenerator.h"
+
+using namespace s21;
+
+int main(int argc, char *argv[]) {
+  MeshSpec spec;
+  ObjIndexStyle style = ObjIndexStyle::kPositive;
+  std::string output;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--shape" && hasValue) {
+      if (!MeshGenerator::parseShape(argv[++i], spec.shape)) {
+        std::cerr << "Error: Unknown shape " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (arg == "--faces" && hasValue) {
+      spec.faces = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--seed" && hasValue) {
+      spec.seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--indices" && hasValue) {
+      std::string name = argv[++i];
+      if (name == "positive") {
+        style = ObjIndexStyle::kPositive;
+      } else if (name == "negative") {
+        style = ObjIndexStyle::kNegative;
+      } else if (name == "mixed") {
+        style = ObjIndexStyle::kMixed;
+      } else {
+        std::cerr << "Error: Unknown index style " << name << "\n";
+        return 2;
+      }
+    } else if (arg == "--help" || arg == "-h" || !output.empty()) {
+      std::cout << "Usage: " << argv[0]
+                << " [--shape sphere|grid|torus|soup] [--faces N]"
+                   " [--seed S] [--indices positive|negative|mixed]"
+                   " output.obj\n";
+      return arg == "--help" || arg == "-h" ? 0 : 2;
+    } else {
+      output = arg;
+    }
+  }
+  if (output.empty()) {
+    std::cerr << "Error: No output file\n";
+    return 2;
+  }
+
+  try {
+    if (!MeshGenerator::writeObj(spec, output, style)) {
+      std::cerr << "Error: Cannot write file " << output << "\n";
+      return 1;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    std::filesystem::remove(output);
+    return 1;
+  }
+  std::cout << MeshGenerator::describe(spec) << " -> " << output << " ("
+            << std::filesystem::file_size(output) << " bytes)\n";
+  return 0;
+}
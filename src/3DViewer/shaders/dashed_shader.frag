@@ -1,6 +1,8 @@
+VARYING float dashCoord;
+
 void MAIN() {
-    // Используем UV0.x как параметр для расчета паттерна
-    float pattern = mod(UV0.x / (dashLength + gapLength), 1.0);
+    // Используем x вершины (из вершинного шейдера) как параметр для расчета паттерна
+    float pattern = mod(dashCoord / (dashLength + gapLength), 1.0);
     if (pattern > dashLength / (dashLength + gapLength)) {
         discard; // Пропуск части линии
     }
@@ -0,0 +1,7 @@
+VARYING float dashCoord;
+
+void MAIN() {
+    // Координата для расчета паттерна: x вершины в системе модели
+    dashCoord = VERTEX.x;
+    POSITION = MODELVIEWPROJECTION_MATRIX * vec4(VERTEX, 1.0);
+}
\ No newline at end of file
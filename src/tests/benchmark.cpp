@@ -0,0 +1,539 @@
+/**
+ * @file benchmark.cpp
+ * @brief Микробенчмарки ядра 3DViewer (Google Benchmark).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "../3DViewer/adapter/geometryadditions.h"
+#include "../3DViewer/adapter/linesgeometry.h"
+#include "../3DViewer/core/bvh.h"
+#include "../3DViewer/core/model3d.h"
+#include "../3DViewer/io/meshgenerator.h"
+#include "../3DViewer/io/objloader.h"
+
+using namespace s21;
+
+namespace {
+
+/**
+ * @brief Текущий объём занятой кучи в байтах (0, если неизвестен).
+ */
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;  // Куча и крупные блоки через mmap
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Индексы i-го четырёхугольника сетки.
+ */
+std::vector<int> quadIndices(int i) { return {i, i + 1, i + 2, i + 3}; }
+
+/**
+ * @brief Грани в прежнем формате: отдельный вектор на каждую грань.
+ *
+ * Эта функция и makePolygonList() строят одну и ту же цепочку граней
+ * вручную, а не через MeshGenerator: BM_BuildPolygons измеряет только
+ * построение контейнера, а MeshGenerator выдаёт готовый Model3D и только в
+ * формате CSR.
+ */
+std::vector<Polygon> makeVectorOfPolygons(int count) {
+  std::vector<Polygon> polygons;
+  polygons.reserve(count);
+  for (int i = 0; i < count; ++i) polygons.emplace_back(quadIndices(i));
+  return polygons;
+}
+
+/**
+ * @brief Те же грани в формате CSR.
+ */
+PolygonList makePolygonList(int count) {
+  PolygonList polygons;
+  polygons.reserve(count, size_t(count) * 4);
+  int quad[4];
+  for (int i = 0; i < count; ++i) {
+    for (int k = 0; k < 4; ++k) quad[k] = i + k;
+    polygons.push_back(std::span<const int>(quad));
+  }
+  return polygons;
+}
+
+/**
+ * @brief Построение граней; счётчик heap_bytes — память под грани.
+ */
+template <typename Polygons, Polygons (*make)(int)>
+void BM_BuildPolygons(benchmark::State& state) {
+  int count = static_cast<int>(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    size_t before = heapInUse();
+    Polygons polygons = make(count);
+    bytes = heapInUse() - before;
+    benchmark::DoNotOptimize(polygons);
+  }
+  state.counters["heap_bytes"] = static_cast<double>(bytes);
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+/**
+ * @brief Перебор граней с построением рёбер (convertToLines()).
+ */
+template <typename Polygons, Polygons (*make)(int)>
+void BM_PolygonsToLines(benchmark::State& state) {
+  Polygons polygons = make(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::vector<int> lines = convertToLines(polygons);
+    benchmark::DoNotOptimize(lines.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Сетка MeshGenerator примерно из count четырёхугольников:
+ * внутренние рёбра общие у двух граней, как на замкнутой поверхности.
+ */
+Model3D makeGrid(int64_t count) {
+  return MeshGenerator::model(
+      MeshSpec{MeshShape::kGrid, static_cast<size_t>(count)});
+}
+
+/**
+ * @brief Только грани сетки makeGrid(): вершины ядрам граней не нужны.
+ */
+PolygonList makeGridFaces(int64_t count) { return makeGrid(count).polygons; }
+
+/**
+ * @brief Рёбра сетки: все рёбра граней или только уникальные; счётчик
+ * line_indices — размер индексного буфера.
+ */
+template <std::vector<int> (*convert)(const PolygonList&)>
+void BM_GridLines(benchmark::State& state) {
+  PolygonList grid = makeGridFaces(state.range(0));
+  size_t indices = 0;
+  for (auto _ : state) {
+    std::vector<int> lines = convert(grid);
+    indices = lines.size();
+    benchmark::DoNotOptimize(lines.data());
+  }
+  state.counters["line_indices"] = static_cast<double>(indices);
+  state.SetItemsProcessed(state.iterations() * grid.size());
+}
+
+/**
+ * @brief Триангуляция граней сетки веером (convertToTriangles()).
+ */
+void BM_GridTriangles(benchmark::State& state) {
+  PolygonList grid = makeGridFaces(state.range(0));
+  for (auto _ : state) {
+    std::vector<int> triangles = convertToTriangles(grid);
+    benchmark::DoNotOptimize(triangles.data());
+  }
+  state.SetItemsProcessed(state.iterations() * grid.size());
+}
+
+/**
+ * @brief Рёбра треугольников сетки (convertTrianglesToLines()).
+ */
+void BM_TrianglesToLines(benchmark::State& state) {
+  std::vector<int> triangles =
+      convertToTriangles(makeGridFaces(state.range(0)));
+  for (auto _ : state) {
+    std::vector<int> lines = convertTrianglesToLines(triangles);
+    benchmark::DoNotOptimize(lines.data());
+  }
+  state.SetItemsProcessed(state.iterations() * triangles.size() / 3);
+}
+
+/**
+ * @brief Буфер индексов рёбер сетки (LinesGeometry::packLineIndices());
+ * счётчик index_bytes — размер буфера, индексы 16-битные до 65536 вершин.
+ */
+void BM_PackLineIndices(benchmark::State& state) {
+  Model3D grid = makeGrid(state.range(0));
+  qsizetype bytes = 0;
+  for (auto _ : state) {
+    QByteArray data =
+        LinesGeometry::packLineIndices(grid.polygons, grid.vertices.size());
+    bytes = data.size();
+    benchmark::DoNotOptimize(data.data());
+  }
+  state.counters["index_bytes"] = static_cast<double>(bytes);
+  state.SetItemsProcessed(state.iterations() * grid.polygons.size());
+}
+
+/**
+ * @brief Нормализованные вершины сферы MeshGenerator — примерно count
+ * вершин (у сферы их столько же, сколько граней); грани отброшены, ядрам
+ * вершин они не нужны.
+ */
+Model3D makeVertexCloud(int64_t count) {
+  Model3D model = MeshGenerator::model(
+      MeshSpec{MeshShape::kSphere, static_cast<size_t>(count)});
+  model.polygons = PolygonList();
+  model.normalizeModel();
+  return model;
+}
+
+/**
+ * @brief Центр масс с пересчётом по вершинам: resetPosition() сбрасывает
+ * кэш статистики, как после загрузки модели.
+ */
+void BM_CalculateCenter(benchmark::State& state) {
+  Model3D model = makeVertexCloud(state.range(0));
+  for (auto _ : state) {
+    model.resetPosition();
+    Vertex center = model.calculateCenter();
+    benchmark::DoNotOptimize(center);
+  }
+  state.SetItemsProcessed(state.iterations() * model.vertices.size());
+}
+
+/**
+ * @brief Нормализация модели (бокс, центр и один проход преобразования).
+ */
+void BM_NormalizeModel(benchmark::State& state) {
+  Model3D model = makeVertexCloud(state.range(0));
+  for (auto _ : state) {
+    model.normalizeModel();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * model.vertices.size());
+}
+
+/**
+ * @brief Поворот модели в наборе инструкций по умолчанию.
+ */
+void BM_RotateModelSize(benchmark::State& state) {
+  Model3D model = makeVertexCloud(state.range(0));
+  float angle = 0;
+  for (auto _ : state) {
+    model.rotateModel(angle, angle * 2, angle * 3);
+    angle += 1;
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * model.vertices.size());
+}
+
+/**
+ * @brief Упаковка вершин в буфер геометрии (LinesGeometry::packVertices()).
+ */
+void BM_PackVertices(benchmark::State& state) {
+  Model3D model = makeVertexCloud(state.range(0));
+  for (auto _ : state) {
+    QByteArray data = LinesGeometry::packVertices(model.vertices);
+    benchmark::DoNotOptimize(data.data());
+  }
+  state.SetBytesProcessed(state.iterations() * model.vertices.size() *
+                          sizeof(Vertex));
+}
+
+/**
+ * @brief Прежний поворот: копия начальной позиции, три прохода (сдвиг,
+ * поворот, обратный сдвиг) и поэлементные вычисления на каждой вершине.
+ */
+void rotateThreePass(Model3D& model, const std::vector<Vertex>& position,
+                     float angleX, float angleY, float angleZ) {
+  model.vertices = position;
+  Vertex center = model.calculateCenter();
+  float radX = angleX * M_PI / 180.0f;
+  float radY = angleY * M_PI / 180.0f;
+  float radZ = angleZ * M_PI / 180.0f;
+  float cosX = std::cos(radX), sinX = std::sin(radX);
+  float cosY = std::cos(radY), sinY = std::sin(radY);
+  float cosZ = std::cos(radZ), sinZ = std::sin(radZ);
+  for (auto& vertex : model.vertices) vertex -= center;
+  for (auto& vertex : model.vertices) {
+    float x = vertex.x, y = vertex.y, z = vertex.z;
+    float newY = y * cosX - z * sinX;
+    float newZ = y * sinX + z * cosX;
+    y = newY;
+    z = newZ;
+    float newX = x * cosY + z * sinY;
+    newZ = -x * sinY + z * cosY;
+    x = newX;
+    z = newZ;
+    newX = x * cosZ - y * sinZ;
+    newY = x * sinZ + y * cosZ;
+    vertex.x = newX;
+    vertex.y = newY;
+    vertex.z = z;
+  }
+  for (auto& vertex : model.vertices) vertex += center;
+}
+
+void BM_RotateThreePass(benchmark::State& state) {
+  Model3D model = makeVertexCloud(state.range(0));
+  const std::vector<Vertex> position = model.vertices;
+  float angle = 0;
+  for (auto _ : state) {
+    rotateThreePass(model, position, angle, angle * 2, angle * 3);
+    angle += 1;
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * model.vertices.size());
+}
+
+/**
+ * @brief Поворот Model3D::rotateModel() (одна матрица, векторное ядро) в
+ * наборе инструкций state.range(1).
+ */
+void BM_RotateModel(benchmark::State& state) {
+  Model3D model = makeVertexCloud(state.range(0));
+  SimdIsa previous = VertexKernels::isa();
+  VertexKernels::isa() = static_cast<SimdIsa>(state.range(1));
+  float angle = 0;
+  for (auto _ : state) {
+    model.rotateModel(angle, angle * 2, angle * 3);
+    angle += 1;
+    benchmark::ClobberMemory();
+  }
+  VertexKernels::isa() = previous;
+  state.SetItemsProcessed(state.iterations() * model.vertices.size());
+}
+
+/**
+ * @brief Поворот вершин в формате VertexSoA на месте.
+ */
+void BM_RotateSoA(benchmark::State& state) {
+  Model3D model = makeVertexCloud(state.range(0));
+  VertexSoA vertices(reinterpret_cast<const float*>(model.vertices.data()),
+                     model.vertices.size());
+  SimdIsa previous = VertexKernels::isa();
+  VertexKernels::isa() = static_cast<SimdIsa>(state.range(1));
+  for (auto _ : state) {
+    VertexKernels::rotate(vertices, 1, 2, 3);
+    benchmark::ClobberMemory();
+  }
+  VertexKernels::isa() = previous;
+  state.SetItemsProcessed(state.iterations() * model.vertices.size());
+}
+
+/**
+ * @brief Нормализация и поворот модели из 20M вершин на state.range(0)
+ * потоках ThreadPool.
+ */
+void BM_ParallelKernels(benchmark::State& state) {
+  static Model3D model = makeVertexCloud(20000000);
+  unsigned previous = VertexKernels::maxThreads();
+  VertexKernels::maxThreads() = static_cast<unsigned>(state.range(0));
+  float angle = 0;
+  for (auto _ : state) {
+    model.normalizeModel();
+    model.rotateModel(angle, angle * 2, angle * 3);
+    angle += 1;
+    benchmark::ClobberMemory();
+  }
+  VertexKernels::maxThreads() = previous;
+  state.SetItemsProcessed(state.iterations() * model.vertices.size());
+}
+
+/**
+ * @brief Волнистая сетка примерно из count рёбер с вершинами и уникальными
+ * рёбрами (по два ребра на четырёхугольник).
+ */
+struct GridEdges {
+  Model3D model;
+  std::vector<int> lines;
+};
+
+GridEdges makeGridEdges(int64_t count) {
+  GridEdges grid{makeGrid(count / 2), {}};
+  grid.model.normalizeModel();
+  grid.lines = convertToUniqueLines(grid.model.polygons);
+  return grid;
+}
+
+/**
+ * @brief Лучи сверху через случайные точки сетки.
+ */
+std::vector<Ray> makePickRays(size_t count) {
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> coordinate(-5.0f, 5.0f);
+  std::vector<Ray> rays(count);
+  for (Ray& ray : rays) {
+    ray.origin[0] = coordinate(random);
+    ray.origin[1] = coordinate(random);
+    ray.origin[2] = 20.0f;
+  }
+  return rays;
+}
+
+/**
+ * @brief Построение Bvh над рёбрами сетки.
+ */
+void BM_BuildBvh(benchmark::State& state) {
+  GridEdges grid = makeGridEdges(state.range(0));
+  for (auto _ : state) {
+    Bvh bvh;
+    bvh.build(grid.model.vertices, grid.lines);
+    benchmark::DoNotOptimize(bvh);
+  }
+  state.SetItemsProcessed(state.iterations() * grid.lines.size() / 2);
+}
+
+/**
+ * @brief Выбор ребра под курсором: Bvh::closest() (state.range(1) == 1)
+ * или перебор всех рёбер Bvh::scan().
+ */
+void BM_PickEdge(benchmark::State& state) {
+  GridEdges grid = makeGridEdges(state.range(0));
+  Bvh bvh;
+  if (state.range(1)) bvh.build(grid.model.vertices, grid.lines);
+  std::vector<Ray> rays = makePickRays(64);
+  size_t next = 0;
+  for (auto _ : state) {
+    const Ray& ray = rays[next++ % rays.size()];
+    BvhHit hit = state.range(1)
+                     ? bvh.closest(grid.model.vertices, ray, 0.01f)
+                     : Bvh::scan(grid.model.vertices, grid.lines, ray, 0.01f);
+    benchmark::DoNotOptimize(hit);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+constexpr int kMaxMeshSize = 50000000;  ///< Наибольший размер модели
+
+/**
+ * @brief Размеры модели (граней или вершин) от 1K до kMaxMeshSize.
+ */
+void meshSizes(benchmark::internal::Benchmark* benchmark) {
+  for (int size = 1 << 10; size < kMaxMeshSize; size *= 16) {
+    benchmark->Arg(size);
+  }
+  benchmark->Arg(kMaxMeshSize);
+}
+
+/**
+ * @brief Разбор текста OBJ синтетической модели (MeshGenerator) формы
+ * state.range(1): parseObj() или parseObjParallel() (state.range(2) == 1).
+ * Индексы граней чередуются между абсолютными и относительными.
+ */
+void BM_ParseObj(benchmark::State& state) {
+  MeshSpec spec{static_cast<MeshShape>(state.range(1)),
+                static_cast<size_t>(state.range(0)), 1};
+  std::string text = MeshGenerator::objText(spec, ObjIndexStyle::kMixed);
+  for (auto _ : state) {
+    Model3D model;
+    if (state.range(2)) {
+      ObjParser::parseObjParallel(text, model);
+    } else {
+      ObjParser::parseObj(text, model);
+    }
+    benchmark::DoNotOptimize(model.vertices.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Число потоков от 1 до всех потоков пула (степени двойки).
+ */
+void threadArguments(benchmark::internal::Benchmark* benchmark) {
+  unsigned all = ThreadPool::instance().concurrency();
+  for (unsigned threads = 1; threads < all; threads *= 2) {
+    benchmark->Arg(threads);
+  }
+  benchmark->Arg(all);
+}
+
+/**
+ * @brief Наборы инструкций, доступные на этой машине.
+ */
+void simdArguments(benchmark::internal::Benchmark* benchmark) {
+  SimdIsa best = detectSimdIsa();
+  for (int size : {1 << 16, 5000000}) {
+    for (SimdIsa isa : {SimdIsa::kScalar, SimdIsa::kSse2, SimdIsa::kAvx2}) {
+      if (isa <= best) benchmark->Args({size, static_cast<int>(isa)});
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_RotateThreePass)
+    ->Arg(1 << 16)
+    ->Arg(5000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RotateModel)
+    ->Apply(simdArguments)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RotateSoA)->Apply(simdArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RotateModelSize)
+    ->Apply(meshSizes)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CalculateCenter)
+    ->Apply(meshSizes)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_NormalizeModel)
+    ->Apply(meshSizes)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PackVertices)
+    ->Apply(meshSizes)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelKernels)
+    ->Apply(threadArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_BuildPolygons, std::vector<Polygon>, makeVectorOfPolygons)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BuildPolygons, PolygonList, makePolygonList)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PolygonsToLines, std::vector<Polygon>,
+                   makeVectorOfPolygons)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PolygonsToLines, PolygonList, makePolygonList)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GridLines, convertToLines)
+    ->Apply(meshSizes)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GridLines, convertToUniqueLines)
+    ->Apply(meshSizes)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GridTriangles)->Apply(meshSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TrianglesToLines)
+    ->Apply(meshSizes)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PackLineIndices)
+    ->Apply(meshSizes)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseObj)
+    ->ArgsProduct({{1 << 10, 1 << 14, 1 << 18, 1 << 22},
+                   {static_cast<int>(MeshShape::kGrid),
+                    static_cast<int>(MeshShape::kSoup)},
+                   {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BuildBvh)
+    ->RangeMultiplier(16)
+    ->Range(1 << 16, 10000000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PickEdge)
+    ->ArgsProduct({{1 << 16, 1 << 20, 10000000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -1,8 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <random>
+
+#include "../io/meshcache.h"
 #include "../io/objloader.h"
 #include "fasade.h"
+#include "bvh.h"
+#include "frustum.h"
 #include "geometryadditions.h"
+#include "meshgenerator.h"
+#include "meshlod.h"
 #include "model3d.h"
 #include "objloader.h"
 
@@ -105,6 +114,425 @@ TEST_F(ModelLoadingTest, LoadWithNegativeIndices) {
 TEST_F(ModelLoadingTest, InvalidFile) {
   EXPECT_FALSE(ObjParser::loadObj("nonexistent.obj", model));
 }
+
+TEST_F(ModelLoadingTest, MappedInvalidFile) {
+  EXPECT_FALSE(ObjParser::loadObjMapped("nonexistent.obj", model));
+}
+
+TEST_F(ModelLoadingTest, MappedEmptyObj) {
+  std::ofstream out("mapped_empty.obj");
+  out.close();
+
+  EXPECT_TRUE(ObjParser::loadObjMapped("mapped_empty.obj", model));
+  EXPECT_EQ(model.vertices.size(), 0);
+  EXPECT_EQ(model.polygons.size(), 0);
+  std::remove("mapped_empty.obj");
+}
+
+TEST_F(ModelLoadingTest, MappedMatchesStream) {
+  std::ofstream out("mapped.obj");
+  out << "# comment\n";
+  out << "v 0 0 0\r\nv\t1.5 -2e-1 +3\nvn 0 0 1\nvt 0.5 0.5\n";
+  out << "v 0 1 0\n\n   v 1 1 1\n";
+  out << "f 1/1/1 2//1 3\r\n";
+  out << "f -4 -3 -2 -1\n";
+  out << "f 1 2 4";  // Без перевода строки в конце файла
+  out.close();
+
+  Model3D streamModel;
+  ASSERT_TRUE(ObjParser::loadObj("mapped.obj", streamModel));
+  ASSERT_TRUE(ObjParser::loadObjMapped("mapped.obj", model));
+
+  ASSERT_EQ(model.vertices.size(), streamModel.vertices.size());
+  for (size_t i = 0; i < model.vertices.size(); ++i) {
+    EXPECT_FLOAT_EQ(model.vertices[i].x, streamModel.vertices[i].x);
+    EXPECT_FLOAT_EQ(model.vertices[i].y, streamModel.vertices[i].y);
+    EXPECT_FLOAT_EQ(model.vertices[i].z, streamModel.vertices[i].z);
+  }
+  ASSERT_EQ(model.polygons.size(), 3);
+  ASSERT_EQ(model.polygons.size(), streamModel.polygons.size());
+  for (size_t i = 0; i < model.polygons.size(); ++i) {
+    EXPECT_EQ(model.polygons[i], streamModel.polygons[i]);
+  }
+  std::remove("mapped.obj");
+}
+
+TEST_F(ModelLoadingTest, ParallelMatchesSequential) {
+  std::ostringstream obj;
+  for (int i = 0; i < 200; ++i) {
+    obj << "v " << i << " " << i * 0.5 << " " << -i << "\n";
+    if (i >= 3 && i % 3 == 0) {
+      obj << "f " << i - 2 << "/1 " << i - 1 << "//2 " << i << "\n";
+      obj << "f -1 -2 -3 -4\n";  // Отрицательные индексы на границах частей
+    }
+  }
+  std::string data = obj.str();
+
+  Model3D sequential;
+  sequential.addVertex(Vertex(9, 9, 9));  // Вершина до начала файла
+  ObjParser::parseObj(data, sequential);
+
+  model.addVertex(Vertex(9, 9, 9));
+  ObjParser::parseObjParallel(data, model, 7, 1);
+
+  ASSERT_EQ(model.vertices.size(), sequential.vertices.size());
+  for (size_t i = 0; i < model.vertices.size(); ++i) {
+    EXPECT_FLOAT_EQ(model.vertices[i].x, sequential.vertices[i].x);
+    EXPECT_FLOAT_EQ(model.vertices[i].y, sequential.vertices[i].y);
+    EXPECT_FLOAT_EQ(model.vertices[i].z, sequential.vertices[i].z);
+  }
+  ASSERT_EQ(model.polygons.size(), sequential.polygons.size());
+  for (size_t i = 0; i < model.polygons.size(); ++i) {
+    EXPECT_EQ(model.polygons[i], sequential.polygons[i]);
+  }
+}
+
+TEST_F(ModelLoadingTest, ParallelInvalidIndex) {
+  std::string forward = "v 0 0 0\nv 1 1 1\nf 1 2 1\nf 1 2 3\nv 2 2 2\n";
+  EXPECT_THROW(ObjParser::parseObjParallel(forward, model, 4, 1),
+               std::out_of_range);
+  EXPECT_TRUE(model.vertices.empty());  // Модель не изменяется при ошибке
+
+  std::string relative = "v 0 0 0\nf -1 -1 -1\nv 1 1 1\nf -3 -1 -2\n";
+  EXPECT_THROW(ObjParser::parseObjParallel(relative, model, 4, 1),
+               std::out_of_range);
+  EXPECT_THROW(ObjParser::parseObjParallel("v 0 0 0\nf 1 a 1\n", model, 4, 1),
+               std::invalid_argument);
+}
+
+TEST_F(ModelLoadingTest, ProgressAndCancel) {
+  std::string data;
+  for (int i = 0; i < 100000; ++i) data += "v 1.0 2.0 3.0\n";
+
+  std::atomic<bool> cancelled = false;
+  std::atomic<size_t> lastConsumed = 0;
+  ParseControl control;
+  control.cancelled = &cancelled;
+  control.onProgress = [&](size_t consumed, size_t total) {
+    EXPECT_EQ(total, data.size());
+    lastConsumed = std::max(lastConsumed.load(), consumed);
+  };
+
+  EXPECT_TRUE(ObjParser::parseObjParallel(data, model, 4, 1, &control));
+  EXPECT_EQ(lastConsumed, data.size());
+  EXPECT_EQ(model.vertices.size(), 100000);
+
+  cancelled = true;
+  Model3D cancelledModel;
+  EXPECT_FALSE(ObjParser::parseObj(data, cancelledModel, &control));
+  EXPECT_FALSE(
+      ObjParser::parseObjParallel(data, cancelledModel, 4, 1, &control));
+}
+
+TEST_F(ModelLoadingTest, StreamingBatches) {
+  std::string data;
+  for (int i = 0; i < 100000; ++i) {
+    data += "v " + std::to_string(i) + " 0 0\n";
+    if (i >= 2) data += "f -1 -2 -3\n";
+  }
+
+  std::vector<std::pair<size_t, size_t>> batches;
+  size_t lastConsumed = 0;
+  ParseControl control;
+  control.onBatch = [&](const Model3D& partial, size_t consumed,
+                        size_t total) {
+    batches.emplace_back(partial.vertices.size(), partial.polygons.size());
+    EXPECT_GE(consumed, lastConsumed);
+    EXPECT_EQ(total, data.size());
+    lastConsumed = consumed;
+  };
+
+  EXPECT_TRUE(ObjParser::parseObj(data, model, &control));
+  ASSERT_GT(batches.size(), 2);
+  for (size_t i = 1; i < batches.size(); ++i) {
+    EXPECT_GE(batches[i].first, batches[i - 1].first);
+    EXPECT_GE(batches[i].second, batches[i - 1].second);
+  }
+  EXPECT_EQ(batches.back().first, model.vertices.size());
+  EXPECT_EQ(batches.back().second, model.polygons.size());
+  EXPECT_EQ(lastConsumed, data.size());
+
+  Vertex center;
+  float scale;
+  EXPECT_FALSE(Model3D::normalizationFor({}, center, scale));
+  ASSERT_TRUE(Model3D::normalizationFor(model.vertices, center, scale));
+  EXPECT_FLOAT_EQ(center.x, 99999.0f / 2);
+  EXPECT_FLOAT_EQ(scale, Model3D::kNormalizedSize / 99999.0f);
+}
+
+TEST_F(ModelLoadingTest, ParallelStreamingPublishesFilePrefix) {
+  MeshSpec spec{MeshShape::kSoup, 20000, 3};
+  std::string data = MeshGenerator::objText(spec, ObjIndexStyle::kMixed);
+  Model3D expected;
+  ObjParser::parseObj(data, expected);
+
+  // Каждая публикация — модель, разобранная из начала файла длиной consumed
+  size_t calls = 0;
+  size_t lastConsumed = 0;
+  ParseControl control;
+  control.onBatch = [&](const Model3D& partial, size_t consumed,
+                        size_t total) {
+    ++calls;
+    EXPECT_EQ(total, data.size());
+    EXPECT_GT(consumed, lastConsumed);
+    ASSERT_TRUE(consumed == data.size() || data[consumed - 1] == '\n');
+    lastConsumed = consumed;
+    Model3D prefix;
+    ObjParser::parseObj(std::string_view(data).substr(0, consumed), prefix);
+    ASSERT_EQ(partial.vertices.size(), prefix.vertices.size());
+    ASSERT_EQ(partial.polygons.size(), prefix.polygons.size());
+  };
+
+  ASSERT_TRUE(ObjParser::parseObjParallel(data, model, 7, 1, &control));
+  EXPECT_GT(calls, 0u);
+  EXPECT_EQ(lastConsumed, data.size());
+  ASSERT_EQ(model.polygons.size(), expected.polygons.size());
+  for (size_t i = 0; i < model.polygons.size(); ++i) {
+    ASSERT_EQ(model.polygons[i], expected.polygons[i]) << "face " << i;
+  }
+
+  ParseControl brokenControl;
+  brokenControl.onBatch = [](const Model3D&, size_t, size_t) {};
+  std::string broken = data + "f 1 2 999999\n";
+  Model3D failed;
+  EXPECT_THROW(
+      ObjParser::parseObjParallel(broken, failed, 7, 1, &brokenControl),
+      std::out_of_range);
+}
+
+TEST_F(ModelLoadingTest, GeneratedSoupMatchesInMemoryModel) {
+  MeshSpec spec{MeshShape::kSoup, 20000, 7};
+  Model3D expected = MeshGenerator::model(spec);
+  ASSERT_EQ(expected.polygons.size(), 20000);
+
+  auto expectSame = [&](const Model3D& loaded) {
+    ASSERT_EQ(loaded.vertices.size(), expected.vertices.size());
+    for (size_t i = 0; i < loaded.vertices.size(); ++i) {
+      EXPECT_EQ(loaded.vertices[i].x, expected.vertices[i].x);
+      EXPECT_EQ(loaded.vertices[i].y, expected.vertices[i].y);
+      EXPECT_EQ(loaded.vertices[i].z, expected.vertices[i].z);
+    }
+    ASSERT_EQ(loaded.polygons.size(), expected.polygons.size());
+    for (size_t i = 0; i < loaded.polygons.size(); ++i) {
+      ASSERT_EQ(loaded.polygons[i], expected.polygons[i]) << "face " << i;
+    }
+  };
+
+  // Относительные индексы на границах частей параллельного разбора
+  std::string data = MeshGenerator::objText(spec, ObjIndexStyle::kMixed);
+  Model3D parsed, parallel;
+  ObjParser::parseObj(data, parsed);
+  expectSame(parsed);
+  ObjParser::parseObjParallel(data, parallel, 7, 1);
+  expectSame(parallel);
+
+  ASSERT_TRUE(MeshGenerator::writeObj(spec, "generated.obj",
+                                      ObjIndexStyle::kNegative));
+  Model3D stream, mapped;
+  ASSERT_TRUE(ObjParser::loadObj("generated.obj", stream));
+  expectSame(stream);
+  ASSERT_TRUE(ObjParser::loadObjMapped("generated.obj", mapped));
+  expectSame(mapped);
+  std::remove("generated.obj");
+}
+
+TEST(ObjTokenizerTest, IndexTriplet) {
+  IndexTriplet full = ObjTokenizer::parseIndexTriplet("12/34/56");
+  EXPECT_EQ(full.v, 12);
+  EXPECT_EQ(full.vt, 34);
+  EXPECT_EQ(full.vn, 56);
+
+  IndexTriplet noTexture = ObjTokenizer::parseIndexTriplet("-7//3");
+  EXPECT_EQ(noTexture.v, -7);
+  EXPECT_EQ(noTexture.vt, 0);
+  EXPECT_EQ(noTexture.vn, 3);
+
+  EXPECT_EQ(ObjTokenizer::parseIndexTriplet("+5/2").v, 5);
+  EXPECT_EQ(ObjTokenizer::parseIndexTriplet("-2147483648").v, INT_MIN);
+  EXPECT_THROW(ObjTokenizer::parseIndexTriplet("/1/1"), std::invalid_argument);
+  EXPECT_THROW(ObjTokenizer::parseIndexTriplet("2147483648"),
+               std::out_of_range);
+}
+
+TEST(ObjTokenizerTest, TokensAndLines) {
+  for (auto isa : {ObjTokenizer::Isa::kScalar, ObjTokenizer::detectIsa()}) {
+    ObjTokenizer::isa() = isa;
+    std::string_view line =
+        "f\t  1/2/3 \r\v4//6                      7_long_token_over_16_bytes";
+    EXPECT_EQ(ObjTokenizer::nextToken(line), "f");
+    EXPECT_EQ(ObjTokenizer::nextToken(line), "1/2/3");
+    EXPECT_EQ(ObjTokenizer::nextToken(line), "4//6");
+    EXPECT_EQ(ObjTokenizer::nextToken(line), "7_long_token_over_16_bytes");
+    EXPECT_EQ(ObjTokenizer::nextToken(line), "");
+
+    std::string data(100, 'x');
+    data[40] = '\n';
+    EXPECT_EQ(ObjTokenizer::findLineEnd(data, 0), 40);
+    EXPECT_EQ(ObjTokenizer::findLineEnd(data, 41), data.size());
+  }
+  ObjTokenizer::isa() = ObjTokenizer::detectIsa();
+}
+
+TEST(ObjTokenizerTest, MatchesStreamOnDataSamples) {
+  size_t files = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(DATA_SAMPLES_DIR)) {
+    if (entry.path().extension() != ".obj") continue;
+    ++files;
+    std::string path = entry.path().string();
+    SCOPED_TRACE(path);
+
+    Model3D expected;
+    ASSERT_TRUE(ObjParser::loadObj(path, expected));
+
+    for (auto isa : {ObjTokenizer::Isa::kScalar, ObjTokenizer::Isa::kSse2,
+                     ObjTokenizer::Isa::kAvx2}) {
+      if (isa > ObjTokenizer::detectIsa()) continue;
+      ObjTokenizer::isa() = isa;
+
+      Model3D actual;
+      ASSERT_TRUE(ObjParser::loadObjMapped(path, actual));
+      ASSERT_EQ(actual.vertices.size(), expected.vertices.size());
+      for (size_t i = 0; i < actual.vertices.size(); ++i) {
+        ASSERT_EQ(actual.vertices[i].x, expected.vertices[i].x);
+        ASSERT_EQ(actual.vertices[i].y, expected.vertices[i].y);
+        ASSERT_EQ(actual.vertices[i].z, expected.vertices[i].z);
+      }
+      ASSERT_EQ(actual.polygons.size(), expected.polygons.size());
+      for (size_t i = 0; i < actual.polygons.size(); ++i) {
+        ASSERT_EQ(actual.polygons[i], expected.polygons[i]);
+      }
+    }
+  }
+  ObjTokenizer::isa() = ObjTokenizer::detectIsa();
+  EXPECT_GT(files, 0);
+}
+
+TEST_F(ModelLoadingTest, MappedInvalidIndex) {
+  EXPECT_THROW(ObjParser::parseObj("v 0 0 0\nf 1 x 1\n", model),
+               std::invalid_argument);
+  EXPECT_THROW(ObjParser::parseObj("v 0 0 0\nf 1 5 1\n", model),
+               std::out_of_range);
+}
+TEST(MeshCacheTest, RoundTripAndInvalidation) {
+  {
+    std::ofstream out("cached.obj");
+    out << "v 0 0 0\nv 2 0 0\nv 0 4 0\nv 0 0 6\nf 1 2 3\nf 1 2 3 4\n";
+  }
+  Model3D source;
+  ASSERT_TRUE(ObjParser::loadObjMapped("cached.obj", source));
+  source.normalizeModel();
+
+  std::string cacheFile = MeshCache::cachePath("mesh_cache", "cached.obj");
+  ASSERT_TRUE(MeshCache::write(cacheFile, "cached.obj", source));
+
+  Model3D cached;
+  MeshCacheHeader header;
+  ASSERT_TRUE(MeshCache::read(cacheFile, "cached.obj", cached, &header));
+  EXPECT_EQ(header.vertexCount, 4);
+  EXPECT_EQ(header.polygonCount, 2);
+  EXPECT_EQ(header.indexCount, 7);
+  EXPECT_FLOAT_EQ(header.bboxMax[2] - header.bboxMin[2], 12.0f);
+  ASSERT_EQ(cached.vertices.size(), source.vertices.size());
+  for (size_t i = 0; i < cached.vertices.size(); ++i) {
+    EXPECT_EQ(cached.vertices[i].x, source.vertices[i].x);
+    EXPECT_EQ(cached.vertices[i].y, source.vertices[i].y);
+    EXPECT_EQ(cached.vertices[i].z, source.vertices[i].z);
+  }
+  ASSERT_EQ(cached.polygons.size(), 2);
+  EXPECT_EQ(cached.polygons[1], Polygon({0, 1, 2, 3}));
+
+  // Другой исходный путь не должен использовать чужой кэш
+  std::filesystem::copy_file("cached.obj", "cached_copy.obj",
+                             std::filesystem::copy_options::overwrite_existing);
+  EXPECT_FALSE(MeshCache::read(cacheFile, "cached_copy.obj", cached));
+
+  // Изменение исходного файла делает кэш устаревшим
+  {
+    std::ofstream out("cached.obj", std::ios::app);
+    out << "v 1 1 1\n";
+  }
+  EXPECT_FALSE(MeshCache::read(cacheFile, "cached.obj", cached));
+
+  std::filesystem::remove_all("mesh_cache");
+  std::remove("cached.obj");
+  std::remove("cached_copy.obj");
+}
+
+TEST(MeshCacheTest, RejectsCorruptedCache) {
+  {
+    std::ofstream out("corrupt.obj");
+    out << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+  }
+  Model3D model;
+  ASSERT_TRUE(ObjParser::loadObjMapped("corrupt.obj", model));
+  ASSERT_TRUE(MeshCache::write("corrupt.v3dcache", "corrupt.obj", model));
+
+  std::filesystem::resize_file(
+      "corrupt.v3dcache", std::filesystem::file_size("corrupt.v3dcache") - 4);
+  EXPECT_FALSE(MeshCache::read("corrupt.v3dcache", "corrupt.obj", model));
+  EXPECT_FALSE(MeshCache::read("missing.v3dcache", "corrupt.obj", model));
+
+  // Число вершин, при котором 12 * vertexCount переполняется и размер
+  // файла формально сходится: кэш отклоняется без попытки выделить память
+  ASSERT_TRUE(MeshCache::write("corrupt.v3dcache", "corrupt.obj", model));
+  {
+    std::fstream file("corrupt.v3dcache",
+                      std::ios::in | std::ios::out | std::ios::binary);
+    uint64_t vertexCount = (uint64_t(1) << 62) + 3;
+    file.seekp(offsetof(MeshCacheHeader, vertexCount));
+    file.write(reinterpret_cast<const char*>(&vertexCount),
+               sizeof(vertexCount));
+  }
+  EXPECT_FALSE(MeshCache::read("corrupt.v3dcache", "corrupt.obj", model));
+
+  std::remove("corrupt.v3dcache");
+  std::remove("corrupt.obj");
+}
+
+TEST(MeshCacheTest, QuantizedPositionsWithinHalfStep) {
+  {
+    std::ofstream out("quantized.obj");
+    for (int i = 0; i < 1000; ++i) {
+      out << "v " << std::sin(i * 0.1) * 3 << ' ' << std::cos(i * 0.37) << ' '
+          << (i % 17) * 0.25 << '\n';
+    }
+    out << "f 1 2 3\nf 998 999 1000\n";
+  }
+  Model3D source;
+  ASSERT_TRUE(ObjParser::loadObjMapped("quantized.obj", source));
+  source.normalizeModel();
+
+  ASSERT_TRUE(MeshCache::write("full.v3dcache", "quantized.obj", source));
+  ASSERT_TRUE(
+      MeshCache::write("compact.v3dcache", "quantized.obj", source, true));
+  EXPECT_LT(std::filesystem::file_size("compact.v3dcache"),
+            std::filesystem::file_size("full.v3dcache") - 5000);
+
+  Model3D cached;
+  MeshCacheHeader header;
+  ASSERT_TRUE(
+      MeshCache::read("compact.v3dcache", "quantized.obj", cached, &header));
+  EXPECT_EQ(header.flags, MeshCache::kQuantizedPositions);
+  ASSERT_EQ(cached.vertices.size(), source.vertices.size());
+  PositionQuantizer quantizer(source.bounds());
+  for (size_t i = 0; i < cached.vertices.size(); ++i) {
+    const float expected[3] = {source.vertices[i].x, source.vertices[i].y,
+                               source.vertices[i].z};
+    const float actual[3] = {cached.vertices[i].x, cached.vertices[i].y,
+                             cached.vertices[i].z};
+    for (int axis = 0; axis < 3; ++axis) {
+      ASSERT_NEAR(actual[axis], expected[axis],
+                  quantizer.step(axis) * 0.5f + 1e-6f);
+    }
+  }
+  EXPECT_EQ(cached.polygons[1], Polygon({997, 998, 999}));
+
+  std::remove("full.v3dcache");
+  std::remove("compact.v3dcache");
+  std::remove("quantized.obj");
+}
+
 class AffineTransformationsTest : public ::testing::Test {
  protected:
   Model3D model;
@@ -442,4 +870,962 @@ TEST(PolygonTest, Iteration) {
     collected.push_back(idx);
   }
   EXPECT_EQ(collected, std::vector<int>({7, 8, 9}));
-}
\ No newline at end of file
+}
+TEST(PolygonListTest, PushBackAndAccess) {
+  PolygonList list;
+  EXPECT_TRUE(list.empty());
+  list.push_back(Polygon({0, 1, 2}));
+  std::vector<int> quad = {3, 4, 5, 6};
+  list.push_back(std::span<const int>(quad));
+  list.push_back(std::span<const int>());
+
+  ASSERT_EQ(list.size(), 3);
+  EXPECT_EQ(list.indexCount(), 7);
+  EXPECT_EQ(list[0], Polygon({0, 1, 2}));
+  EXPECT_EQ(list[1].size(), 4);
+  EXPECT_EQ(list[1][3], 6);
+  EXPECT_THROW(list[1][4], std::out_of_range);
+  EXPECT_TRUE(list[2].empty());
+
+  std::vector<size_t> sizes;
+  for (PolygonView polygon : list) sizes.push_back(polygon.size());
+  EXPECT_EQ(sizes, std::vector<size_t>({3, 4, 0}));
+
+  list.clear();
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(PolygonListTest, Assign) {
+  PolygonList list;
+  list.assign({2, 5}, {0, 1, 2, 3, 4});
+  ASSERT_EQ(list.size(), 2);
+  EXPECT_EQ(list[1], Polygon({2, 3, 4}));
+  EXPECT_THROW(list.assign({3, 2}, {0, 1, 2}), std::invalid_argument);
+  EXPECT_THROW(list.assign({2}, {0, 1, 2}), std::invalid_argument);
+}
+
+TEST(PolygonListTest, ConvertersMatchVectorOfPolygons) {
+  std::vector<Polygon> polygons = {Polygon({0, 1, 2}), Polygon({3, 4, 5, 6})};
+  PolygonList list;
+  for (const auto& polygon : polygons) list.push_back(polygon);
+
+  EXPECT_EQ(convertToLines(list), convertToLines(polygons));
+  EXPECT_EQ(convertToTriangles(list), convertToTriangles(polygons));
+}
+
+TEST(UniqueLinesTest, SharedEdgesEmittedOnce) {
+  // Две грани куба с общим ребром 1-2 (обход в разные стороны) и грань с
+  // повторённой вершиной
+  std::vector<Polygon> polygons = {Polygon({0, 1, 2, 3}),
+                                   Polygon({2, 1, 5, 6}), Polygon({6, 6, 7})};
+  PolygonList list;
+  for (const auto& polygon : polygons) list.push_back(polygon);
+
+  std::vector<int> expected = {0, 1, 0, 3, 1, 2, 1, 5, 2, 3,
+                               2, 6, 5, 6, 6, 7};
+  EXPECT_EQ(convertToUniqueLines(polygons), expected);
+  EXPECT_EQ(convertToUniqueLines(list), expected);
+  EXPECT_EQ(convertToLines(list).size(), 22);
+
+  EXPECT_TRUE(convertToUniqueLines(PolygonList()).empty());
+  EXPECT_THROW(convertToUniqueLines(std::vector<Polygon>{Polygon({4})}),
+               std::runtime_error);
+}
+
+TEST(UniqueLinesTest, LargeIndicesSortedAndUnique) {
+  // Сетка из квадратов: каждое внутреннее ребро принадлежит двум граням
+  const int side = 300;
+  PolygonList grid;
+  for (int row = 0; row < side; ++row) {
+    for (int col = 0; col < side; ++col) {
+      int v = row * (side + 1) + col;
+      int quad[4] = {v, v + 1, v + side + 2, v + side + 1};
+      grid.push_back(std::span<const int>(quad));
+    }
+  }
+
+  std::vector<int> lines = convertToUniqueLines(grid);
+  ASSERT_EQ(lines.size(), size_t(2) * 2 * side * (side + 1));
+  for (size_t i = 0; i < lines.size(); i += 2) {
+    EXPECT_LT(lines[i], lines[i + 1]);
+    if (i > 0) {
+      EXPECT_TRUE(std::pair(lines[i - 2], lines[i - 1]) <
+                  std::pair(lines[i], lines[i + 1]));
+    }
+  }
+}
+
+TEST(UniqueLinesTest, HighValenceFanInShuffledOrder) {
+  // Замкнутый веер: центральная вершина 0 — общая для всех граней
+  const int fan = 200000;
+  std::vector<int> order(fan);
+  for (int i = 0; i < fan; ++i) order[i] = i;
+  std::shuffle(order.begin(), order.end(), std::mt19937(3));
+  PolygonList polygons;
+  for (int i : order) {
+    int triangle[3] = {0, 1 + i, 1 + (i + 1) % fan};
+    polygons.push_back(std::span<const int>(triangle));
+  }
+
+  std::vector<int> lines = convertToUniqueLines(polygons);
+  ASSERT_EQ(lines.size(), size_t(2) * 2 * fan);  // Спицы и обод
+  for (int i = 0; i < fan; ++i) {
+    EXPECT_EQ(lines[2 * i], 0);
+    ASSERT_EQ(lines[2 * i + 1], i + 1);
+  }
+  for (size_t i = 2; i < lines.size(); i += 2) {
+    ASSERT_TRUE(std::pair(lines[i - 2], lines[i - 1]) <
+                std::pair(lines[i], lines[i + 1]));
+  }
+}
+
+TEST(VertexKernelsTest, RotationMatchesSequentialAxes) {
+  AffineTransform rotation = AffineTransform::rotation(30, -45, 120);
+  float x = 1.5f, y = -2.0f, z = 0.25f;
+  rotation.apply(x, y, z);
+
+  // Последовательные повороты вокруг X, Y и Z, как в прежнем rotateModel
+  float rx = 30 * M_PI / 180, ry = -45 * M_PI / 180, rz = 120 * M_PI / 180;
+  float ex = 1.5f, ey = -2.0f, ez = 0.25f;
+  float ny = ey * std::cos(rx) - ez * std::sin(rx);
+  ez = ey * std::sin(rx) + ez * std::cos(rx);
+  ey = ny;
+  float nx = ex * std::cos(ry) + ez * std::sin(ry);
+  ez = -ex * std::sin(ry) + ez * std::cos(ry);
+  ex = nx;
+  nx = ex * std::cos(rz) - ey * std::sin(rz);
+  ey = ex * std::sin(rz) + ey * std::cos(rz);
+  ex = nx;
+
+  EXPECT_NEAR(x, ex, 1e-5f);
+  EXPECT_NEAR(y, ey, 1e-5f);
+  EXPECT_NEAR(z, ez, 1e-5f);
+
+  float px = 1, py = 2, pz = 3;
+  rotation.about(1, 2, 3).apply(px, py, pz);
+  EXPECT_NEAR(px, 1, 1e-6f);
+  EXPECT_NEAR(py, 2, 1e-6f);
+  EXPECT_NEAR(pz, 3, 1e-6f);
+}
+
+TEST(VertexKernelsTest, SimdMatchesScalar) {
+  std::vector<float> xyz;
+  for (int i = 0; i < 3 * 37; ++i) xyz.push_back(std::sin(i * 0.7f) * 10);
+  AffineTransform t = AffineTransform::rotation(10, 20, 30).about(1, -2, 3) *
+                      AffineTransform::scaling(1.5f);
+
+  SimdIsa detected = detectSimdIsa();
+  VertexKernels::isa() = SimdIsa::kScalar;
+  std::vector<float> expected(xyz.size());
+  VertexKernels::transform(t, xyz.data(), expected.data(), 37);
+  BoundingBox expectedBox = VertexKernels::bounds(xyz.data(), 37);
+  PreciseRotation r = PreciseRotation::fromAngles(10, 20, 30);
+  std::vector<float> expectedRotated = xyz;
+  VertexKernels::rotate(r, 1, -2, 3, expectedRotated.data(), 37);
+
+  for (auto isa : {SimdIsa::kScalar, SimdIsa::kSse2, detected}) {
+    if (isa == SimdIsa::kSse2 && detected == SimdIsa::kScalar) continue;
+    VertexKernels::isa() = isa;
+
+    std::vector<float> inPlace = xyz;
+    VertexKernels::transform(t, inPlace.data(), inPlace.data(), 37);
+    VertexSoA soa(xyz.data(), 37);
+    VertexKernels::transform(t, soa);
+    std::vector<float> fromSoa(xyz.size());
+    soa.copyTo(fromSoa.data());
+    for (size_t i = 0; i < xyz.size(); ++i) {
+      EXPECT_NEAR(inPlace[i], expected[i], 1e-4f);
+      EXPECT_NEAR(fromSoa[i], expected[i], 1e-4f);
+    }
+    std::vector<float> rotated = xyz;
+    VertexKernels::rotate(r, 1, -2, 3, rotated.data(), 37);
+    for (size_t i = 0; i < xyz.size(); ++i) {
+      EXPECT_NEAR(rotated[i], expectedRotated[i], 1e-6f);
+    }
+
+    BoundingBox box = VertexKernels::bounds(xyz.data(), 37);
+    BoundingBox soaBox = VertexKernels::bounds(VertexSoA(xyz.data(), 37));
+    for (int axis = 0; axis < 3; ++axis) {
+      EXPECT_EQ(box.min[axis], expectedBox.min[axis]);
+      EXPECT_EQ(box.max[axis], expectedBox.max[axis]);
+      EXPECT_EQ(soaBox.min[axis], expectedBox.min[axis]);
+      EXPECT_EQ(soaBox.max[axis], expectedBox.max[axis]);
+    }
+  }
+  VertexKernels::isa() = detected;
+  EXPECT_TRUE(VertexKernels::bounds(xyz.data(), 0).empty());
+}
+
+TEST(ThreadPoolTest, ParallelForCoversRangeOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> visits(100000);
+  pool.parallelFor(visits.size(), 1000, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) ++visits[i];
+  });
+  for (const auto& visit : visits) ASSERT_EQ(visit.load(), 1);
+
+  // Маленький диапазон не делится и выполняется в вызывающем потоке
+  EXPECT_EQ(pool.partsFor(6, VertexKernels::kParallelGrain), 1);
+  std::thread::id caller = std::this_thread::get_id(), runner;
+  pool.parallelFor(6, VertexKernels::kParallelGrain, [&](size_t, size_t) {
+    runner = std::this_thread::get_id();
+  });
+  EXPECT_EQ(runner, caller);
+  EXPECT_EQ(pool.partsFor(100000, 1000, 2), 2);
+}
+
+TEST(ThreadPoolTest, ParallelForRethrowsAndNests) {
+  ThreadPool pool(3);
+  EXPECT_THROW(pool.parallelFor(1000, 10,
+                                [](size_t begin, size_t) {
+                                  if (begin > 0) throw std::runtime_error("");
+                                }),
+               std::runtime_error);
+
+  // Вложенный цикл в рабочем потоке не блокирует пул
+  std::atomic<size_t> total{0};
+  pool.parallelFor(8, 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      pool.parallelFor(100, 10,
+                       [&](size_t b, size_t e) { total += e - b; });
+    }
+  });
+  EXPECT_EQ(total.load(), 800u);
+}
+
+/**
+ * @brief Занимает единственный рабочий поток пула до вызова release().
+ */
+class BlockedWorker {
+ public:
+  explicit BlockedWorker(ThreadPool& pool) {
+    handle_ = pool.submit([this]() {
+      started_ = true;
+      while (!released_) std::this_thread::yield();
+    });
+    while (!started_) std::this_thread::yield();
+  }
+  ~BlockedWorker() { release(); }
+
+  void release() {
+    released_ = true;
+    handle_.wait();
+  }
+
+ private:
+  std::atomic<bool> started_{false};
+  std::atomic<bool> released_{false};
+  TaskHandle handle_;
+};
+
+/**
+ * @brief Ждёт задачу, не выполняя её в текущем потоке.
+ */
+static void waitUntilDone(const TaskHandle& handle) {
+  while (!handle.done()) std::this_thread::yield();
+}
+
+TEST(ThreadPoolTest, SubmitRunsTaskAndRethrows) {
+  ThreadPool pool(3);
+  int value = 0;
+  TaskHandle handle = pool.submit([&value]() { value = 42; });
+  handle.wait();
+  EXPECT_TRUE(handle.done());
+  EXPECT_FALSE(handle.cancelled());
+  EXPECT_EQ(value, 42);
+
+  TaskHandle failing = pool.submit([]() { throw std::runtime_error(""); });
+  EXPECT_THROW(failing.wait(), std::runtime_error);
+  EXPECT_TRUE(TaskHandle().done());
+}
+
+TEST(ThreadPoolTest, InteractiveTasksRunBeforeBackground) {
+  ThreadPool pool(2);  // Один рабочий поток
+  std::string order;
+  TaskHandle background, interactive;
+  {
+    BlockedWorker blocker(pool);
+    background = pool.submit([&order]() { order += 'b'; },
+                             TaskPriority::kBackground);
+    interactive = pool.submit([&order]() { order += 'i'; },
+                              TaskPriority::kInteractive);
+  }
+  waitUntilDone(background);
+  waitUntilDone(interactive);
+  EXPECT_EQ(order, "ib");
+}
+
+TEST(ThreadPoolTest, CancellationSkipsQueuedAndStopsRunningTasks) {
+  ThreadPool pool(2);
+  CancellationToken token;
+  bool ran = false;
+  TaskHandle queued;
+  {
+    BlockedWorker blocker(pool);
+    queued = pool.submit([&ran]() { ran = true; }, TaskPriority::kBackground,
+                         token);
+    token.cancel();
+  }
+  queued.wait();
+  EXPECT_TRUE(queued.cancelled());
+  EXPECT_FALSE(ran);
+
+  // Запущенная задача сама проверяет токен и завершается
+  CancellationToken running;
+  std::atomic<bool> started{false};
+  TaskHandle loop = pool.submit(
+      [&started, running]() {
+        started = true;
+        while (!running.cancelled()) std::this_thread::yield();
+      },
+      TaskPriority::kBackground, running);
+  while (!started) std::this_thread::yield();
+  running.cancel();
+  loop.wait();
+  EXPECT_FALSE(loop.cancelled());
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealQueuedTasks) {
+  ThreadPool pool(4);
+  constexpr int kTasks = 64;
+  std::atomic<int> finished{0}, stolen{0};
+  TaskHandle outer = pool.submit([&]() {
+    // Задачи попадают в очередь этого потока; он их не берёт, пока занят
+    std::thread::id owner = std::this_thread::get_id();
+    for (int i = 0; i < kTasks; ++i) {
+      pool.submit([&, owner]() {
+        if (std::this_thread::get_id() != owner) ++stolen;
+        ++finished;
+      });
+    }
+    while (finished < kTasks) std::this_thread::yield();
+  });
+  outer.wait();
+  EXPECT_EQ(finished.load(), kTasks);
+  EXPECT_EQ(stolen.load(), kTasks);
+}
+
+TEST(ThreadPoolTest, NestedWaitInsideTaskDoesNotBlock) {
+  ThreadPool pool(2);  // Единственный рабочий поток ждёт свои же задачи
+  std::atomic<int> total{0};
+  TaskHandle outer = pool.submit([&]() {
+    std::vector<TaskHandle> inner;
+    for (int i = 0; i < 8; ++i) {
+      inner.push_back(pool.submit([&total]() { ++total; }));
+    }
+    for (const TaskHandle& task : inner) task.wait();
+  });
+  outer.wait();
+  EXPECT_EQ(total.load(), 8);
+}
+
+TEST(ThreadPoolTest, StressMixedSubmitCancelAndLoops) {
+  ThreadPool pool(4);
+  constexpr int kProducers = 4;
+  constexpr int kTasksPerProducer = 400;
+  std::atomic<long long> work{0};
+  std::atomic<int> executed{0}, skipped{0};
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p]() {
+      std::vector<TaskHandle> handles;
+      CancellationToken token;
+      for (int i = 0; i < kTasksPerProducer; ++i) {
+        if (i % 50 == 0) token = CancellationToken();
+        TaskPriority priority = (i + p) % 3 ? TaskPriority::kInteractive
+                                            : TaskPriority::kBackground;
+        handles.push_back(pool.submit(
+            [&, i]() {
+              ++executed;
+              if (i % 7 == 0) {
+                // Вложенный цикл и вложенные задачи из задачи
+                pool.parallelFor(1000, 100, [&](size_t begin, size_t end) {
+                  work += static_cast<long long>(end - begin);
+                });
+                pool.submit([&work]() { work += 1000; }).wait();
+              } else {
+                work += 1;
+              }
+            },
+            priority, token));
+        if (i % 50 == 49) token.cancel();  // Часть задач ещё в очереди
+      }
+      for (const TaskHandle& handle : handles) {
+        handle.wait();
+        if (handle.cancelled()) ++skipped;
+      }
+    });
+  }
+  for (auto& producer : producers) producer.join();
+
+  EXPECT_EQ(executed + skipped, kProducers * kTasksPerProducer);
+  EXPECT_GE(work.load(), executed.load());
+  EXPECT_LE(work.load(), 2000LL * executed.load());
+}
+
+TEST(VertexKernelsTest, ParallelStatisticsMatchSequential) {
+  const size_t count = 4 * VertexKernels::kParallelGrain + 17;
+  std::vector<float> xyz(3 * count);
+  for (size_t i = 0; i < xyz.size(); ++i) {
+    xyz[i] = std::sin(static_cast<float>(i) * 0.37f) * (i % 7);
+  }
+
+  VertexStatistics stats = VertexKernels::statistics(xyz.data(), count, 4);
+  BoundingBox box = VertexKernels::bounds(xyz.data(), count);
+  double sum[3];
+  VertexKernels::sum(xyz.data(), count, sum);
+  for (int axis = 0; axis < 3; ++axis) {
+    EXPECT_EQ(stats.box.min[axis], box.min[axis]);
+    EXPECT_EQ(stats.box.max[axis], box.max[axis]);
+    EXPECT_NEAR(stats.sum[axis], sum[axis], 1e-6 * count);
+  }
+  EXPECT_TRUE(VertexKernels::statistics(xyz.data(), 0).box.empty());
+}
+
+TEST(Model3DTest, BoundsAndCenterFollowTransforms) {
+  Model3D model;
+  model.addVertex(Vertex(1, 0, 0));
+  model.addVertex(Vertex(0, 3, 0));
+  model.addVertex(Vertex(0, 0, 2));
+  model.addVertex(Vertex(-1, 2, 5));
+  model.normalizeModel();
+
+  auto exactCenter = [&]() {
+    Vertex sum;
+    for (const Vertex& v : model.vertices) sum += v;
+    float n = static_cast<float>(model.vertices.size());
+    return Vertex(sum.x / n, sum.y / n, sum.z / n);
+  };
+  auto expectContainsAll = [&](float slack) {
+    BoundingBox box = model.bounds();
+    for (const Vertex& v : model.vertices) {
+      const float p[3] = {v.x, v.y, v.z};
+      for (int axis = 0; axis < 3; ++axis) {
+        EXPECT_LE(box.min[axis], p[axis] + slack);
+        EXPECT_GE(box.max[axis], p[axis] - slack);
+      }
+    }
+    Vertex center = model.calculateCenter(), expected = exactCenter();
+    EXPECT_NEAR(center.x, expected.x, 1e-4f);
+    EXPECT_NEAR(center.y, expected.y, 1e-4f);
+    EXPECT_NEAR(center.z, expected.z, 1e-4f);
+  };
+
+  // После нормализации бокс точный: наибольший размер равен kNormalizedSize
+  BoundingBox box = model.bounds();
+  float size = std::max({box.max[0] - box.min[0], box.max[1] - box.min[1],
+                         box.max[2] - box.min[2]});
+  EXPECT_NEAR(size, Model3D::kNormalizedSize, 1e-4f);
+  expectContainsAll(1e-4f);
+
+  model.rotateModel(30, 60, 90);
+  expectContainsAll(1e-4f);
+  model.shiftModel(5, -3, 1);
+  expectContainsAll(1e-4f);
+  model.rotateModel(10, 0, 0);
+  expectContainsAll(1e-4f);
+
+  // Сдвиг переносит бокс без изменения размера
+  BoundingBox before = model.bounds();
+  model.shiftModel(6, -3, 1);
+  BoundingBox after = model.bounds();
+  EXPECT_NEAR(after.min[0] - before.min[0], 1, 1e-4f);
+  EXPECT_NEAR(after.max[0] - before.max[0], 1, 1e-4f);
+
+  model.clear();
+  EXPECT_TRUE(model.bounds().empty());
+}
+
+TEST(AffineTransformTest, InverseUndoesTransform) {
+  AffineTransform t = AffineTransform::translation(4, -1, 2) *
+                      AffineTransform::rotation(15, 70, -40).about(1, 2, 3) *
+                      AffineTransform::scaling(2.5f);
+  AffineTransform identity = t.inverse() * t;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_NEAR(identity.m[i][j], i == j ? 1.0f : 0.0f, 1e-5f);
+    }
+  }
+}
+
+TEST(Model3DTest, RotationDragMatchesSingleRotation) {
+  Model3D dragged;
+  dragged.addVertex(Vertex(1, 0, 0));
+  dragged.addVertex(Vertex(0, 3, 0));
+  dragged.addVertex(Vertex(0, 0, 2));
+  dragged.normalizeModel();
+  dragged.shiftModel(0.5f, 0, -1);
+  Model3D direct = dragged;
+
+  // Перетаскивание слайдера: много поворотов подряд
+  for (int angle = 0; angle <= 360; ++angle) {
+    dragged.rotateModel(angle, angle / 2.0f, 0);
+  }
+  dragged.rotateModel(30, 0, 45);
+  direct.rotateModel(30, 0, 45);
+
+  for (size_t i = 0; i < direct.vertices.size(); ++i) {
+    EXPECT_NEAR(dragged.vertices[i].x, direct.vertices[i].x, 1e-4f);
+    EXPECT_NEAR(dragged.vertices[i].y, direct.vertices[i].y, 1e-4f);
+    EXPECT_NEAR(dragged.vertices[i].z, direct.vertices[i].z, 1e-4f);
+  }
+}
+
+TEST(Model3DTest, LongRotationDragDoesNotDrift) {
+  Model3D dragged = MeshGenerator::model({MeshShape::kSoup, 400, 5});
+  dragged.normalizeModel();
+  dragged.shiftModel(1.5f, -2, 0.25f);
+  Model3D direct = dragged;
+
+  // 100k событий ползунка: шаг между поворотами строится в double, и
+  // вершины округляются до float один раз за шаг. Остаётся несмещённый
+  // шум округления (~3e-4 на модели размером 12), без искажения матрицы:
+  // с обратной матрицей во float расхождение было 2.3e-2
+  for (int tick = 0; tick < 100000; ++tick) {
+    dragged.rotateModel(tick % 360, (tick * 7) % 360 / 2.0f, tick % 90);
+  }
+  dragged.rotateModel(30, 0, 45);
+  direct.rotateModel(30, 0, 45);
+
+  ASSERT_EQ(dragged.vertices.size(), direct.vertices.size());
+  Vertex draggedCenter = dragged.calculateCenter();
+  Vertex directCenter = direct.calculateCenter();
+  double draggedSpread = 0, directSpread = 0;
+  for (size_t i = 0; i < direct.vertices.size(); ++i) {
+    EXPECT_NEAR(dragged.vertices[i].x, direct.vertices[i].x, 1e-3f);
+    EXPECT_NEAR(dragged.vertices[i].y, direct.vertices[i].y, 1e-3f);
+    EXPECT_NEAR(dragged.vertices[i].z, direct.vertices[i].z, 1e-3f);
+    Vertex a = dragged.vertices[i] - draggedCenter;
+    Vertex b = direct.vertices[i] - directCenter;
+    draggedSpread += a.x * a.x + a.y * a.y + a.z * a.z;
+    directSpread += b.x * b.x + b.y * b.y + b.z * b.z;
+  }
+  // Модель не сжимается и не растягивается
+  EXPECT_NEAR(draggedSpread / directSpread, 1.0, 1e-5);
+  EXPECT_NEAR(draggedCenter.x, directCenter.x, 1e-5f);
+  EXPECT_NEAR(draggedCenter.y, directCenter.y, 1e-5f);
+  EXPECT_NEAR(draggedCenter.z, directCenter.z, 1e-5f);
+}
+
+TEST(ModelTransformTest, MatchesBakedTransforms) {
+  Model3D eager;
+  eager.addVertex(Vertex(1, 0, 0));
+  eager.addVertex(Vertex(0, 3, 0));
+  eager.addVertex(Vertex(0, 0, 2));
+  eager.addVertex(Vertex(-1, 2, 5));
+  eager.normalizeModel();
+  Model3D lazy = eager;
+  const std::vector<Vertex> pristine = lazy.vertices;
+
+  auto expectNear = [](const std::vector<Vertex>& actual,
+                       const std::vector<Vertex>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+      EXPECT_NEAR(actual[i].x, expected[i].x, 1e-4f);
+      EXPECT_NEAR(actual[i].y, expected[i].y, 1e-4f);
+      EXPECT_NEAR(actual[i].z, expected[i].z, 1e-4f);
+    }
+  };
+  auto expectSame = [&]() {
+    expectNear(lazy.bakedVertices(), eager.vertices);
+    expectNear(lazy.vertices, pristine);  // Вершины не перезаписываются
+  };
+
+  eager.rotateModel(30, 45, 60);
+  lazy.transform.rotate(30, 45, 60);
+  expectSame();
+  eager.shiftModel(1, -2, 3);
+  lazy.transform.shift(1, -2, 3);
+  expectSame();
+  eager.rotateModel(90, 0, 10);
+  lazy.transform.rotate(90, 0, 10);
+  expectSame();
+  eager.shiftModel(-4, 0, 2);
+  lazy.transform.shift(-4, 0, 2);
+  expectSame();
+
+  lazy.resetPosition();
+  expectNear(lazy.bakedVertices(), pristine);
+}
+
+/**
+ * @brief Плоская сетка n x n квадратов в плоскости z = 0 на [0, n] x [0, n].
+ */
+static Model3D makeGrid(int n) {
+  Model3D model;
+  for (int y = 0; y <= n; ++y) {
+    for (int x = 0; x <= n; ++x) model.addVertex(Vertex(x, y, 0));
+  }
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      int a = y * (n + 1) + x;
+      const int quad[4] = {a, a + 1, a + n + 2, a + n + 1};
+      model.addPolygon(std::span<const int>(quad));
+    }
+  }
+  return model;
+}
+
+TEST(MeshSimplifierTest, FlatGridKeepsPlaneAndBoundary) {
+  const int n = 40;
+  Model3D grid = makeGrid(n);
+  MeshSimplifier simplifier(grid);
+  EXPECT_EQ(simplifier.faceCount(), 2u * n * n);
+
+  ASSERT_TRUE(simplifier.simplify(200));
+  EXPECT_LE(simplifier.faceCount(), 200u);
+  Model3D result = simplifier.result();
+  EXPECT_EQ(result.polygons.size(), simplifier.faceCount());
+  EXPECT_LT(result.vertices.size(), grid.vertices.size());
+
+  float minX = n, maxX = 0, minY = n, maxY = 0;
+  for (const Vertex& v : result.vertices) {
+    EXPECT_NEAR(v.z, 0.0f, 1e-4f);
+    minX = std::min(minX, v.x), maxX = std::max(maxX, v.x);
+    minY = std::min(minY, v.y), maxY = std::max(maxY, v.y);
+  }
+  EXPECT_NEAR(minX, 0.0f, 1e-3f);
+  EXPECT_NEAR(maxX, n, 1e-3f);
+  EXPECT_NEAR(minY, 0.0f, 1e-3f);
+  EXPECT_NEAR(maxY, n, 1e-3f);
+  for (PolygonView polygon : result.polygons) EXPECT_EQ(polygon.size(), 3u);
+}
+
+TEST(MeshSimplifierTest, SphereStaysCloseToSurface) {
+  const int rings = 40, segments = 80;
+  Model3D sphere;
+  sphere.addVertex(Vertex(0, 0, 1));
+  for (int r = 1; r < rings; ++r) {
+    double theta = M_PI * r / rings;
+    for (int s = 0; s < segments; ++s) {
+      double phi = 2 * M_PI * s / segments;
+      sphere.addVertex(Vertex(std::sin(theta) * std::cos(phi),
+                              std::sin(theta) * std::sin(phi),
+                              std::cos(theta)));
+    }
+  }
+  sphere.addVertex(Vertex(0, 0, -1));
+  const int last = static_cast<int>(sphere.vertices.size()) - 1;
+  auto ring = [&](int r, int s) {
+    return 1 + (r - 1) * segments + s % segments;
+  };
+  for (int s = 0; s < segments; ++s) {
+    const int top[3] = {0, ring(1, s), ring(1, s + 1)};
+    const int bottom[3] = {last, ring(rings - 1, s + 1), ring(rings - 1, s)};
+    sphere.addPolygon(std::span<const int>(top));
+    sphere.addPolygon(std::span<const int>(bottom));
+    for (int r = 1; r + 1 < rings; ++r) {
+      const int quad[4] = {ring(r, s), ring(r + 1, s), ring(r + 1, s + 1),
+                           ring(r, s + 1)};
+      sphere.addPolygon(std::span<const int>(quad));
+    }
+  }
+
+  MeshSimplifier simplifier(sphere);
+  ASSERT_TRUE(simplifier.simplify(simplifier.faceCount() / 8));
+  Model3D result = simplifier.result();
+  EXPECT_LE(result.polygons.size(), 2u * rings * segments / 8);
+  EXPECT_GT(result.polygons.size(), 0u);
+  for (const Vertex& v : result.vertices) {
+    EXPECT_NEAR(std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z), 1.0, 0.05);
+  }
+}
+
+TEST(MeshSimplifierTest, StagedSimplificationKeepsValidTriangles) {
+  Model3D torus = MeshGenerator::model(MeshSpec{MeshShape::kTorus, 20000, 7});
+  MeshSimplifier simplifier(torus);
+  size_t previous = simplifier.faceCount();
+  for (size_t target : {previous / 4, previous / 16, previous / 64}) {
+    ASSERT_TRUE(simplifier.simplify(target));
+    EXPECT_LE(simplifier.faceCount(), target);
+    EXPECT_LT(simplifier.faceCount(), previous);
+    previous = simplifier.faceCount();
+
+    Model3D result = simplifier.result();
+    ASSERT_EQ(result.polygons.size(), simplifier.faceCount());
+    const int count = static_cast<int>(result.vertices.size());
+    for (PolygonView polygon : result.polygons) {
+      ASSERT_EQ(polygon.size(), 3u);
+      EXPECT_NE(polygon[0], polygon[1]);
+      EXPECT_NE(polygon[1], polygon[2]);
+      EXPECT_NE(polygon[0], polygon[2]);
+      for (int vertex : polygon) {
+        EXPECT_GE(vertex, 0);
+        EXPECT_LT(vertex, count);
+      }
+    }
+  }
+}
+
+TEST(MeshSimplifierTest, CancelledSimplificationStops) {
+  Model3D grid = makeGrid(64);
+  MeshSimplifier simplifier(grid);
+  CancellationToken token;
+  token.cancel();
+  EXPECT_FALSE(simplifier.simplify(10, &token));
+  EXPECT_GT(simplifier.faceCount(), 10u);
+
+  std::vector<Model3D> levels;
+  EXPECT_FALSE(MeshLod::buildChain(makeGrid(240), levels, &token));
+}
+
+TEST(MeshLodTest, ChainShrinksAndLevelFollowsZoom) {
+  std::vector<Model3D> levels;
+  ASSERT_TRUE(MeshLod::buildChain(makeGrid(10), levels));
+  EXPECT_TRUE(levels.empty());  // Маленькая модель не упрощается
+
+  Model3D grid = makeGrid(240);
+  ASSERT_TRUE(MeshLod::buildChain(grid, levels));
+  ASSERT_FALSE(levels.empty());
+  std::vector<size_t> faceCounts = {2 * grid.polygons.size()};
+  for (const Model3D& level : levels) {
+    EXPECT_LT(level.polygons.size(), faceCounts.back());
+    faceCounts.push_back(level.polygons.size());
+  }
+  EXPECT_LE(levels.size() + 1, MeshLod::kMaxLevels);
+
+  // Чем крупнее модель на экране, тем подробнее уровень
+  size_t previous = faceCounts.size();
+  for (double scale : {1.0, 10.0, 50.0, 100.0, 300.0, 3000.0}) {
+    double size = MeshLod::projectedSize(scale, 2000, 60, 800);
+    size_t level = MeshLod::levelFor(size, faceCounts);
+    EXPECT_LE(level, previous);
+    previous = level;
+  }
+  EXPECT_EQ(MeshLod::levelFor(1.0, faceCounts), faceCounts.size() - 1);
+  EXPECT_EQ(MeshLod::levelFor(1e6, faceCounts), 0u);
+
+  // Ближе камера — крупнее модель; ортографическая — масштаб в пикселях
+  EXPECT_GT(MeshLod::projectedSize(100, 500, 60, 800),
+            MeshLod::projectedSize(100, 2000, 60, 800));
+  EXPECT_DOUBLE_EQ(MeshLod::projectedSize(2, 0, 0, 800),
+                   2 * Model3D::kNormalizedSize);
+}
+
+/**
+ * @brief Лучи через случайные точки бокса модели из случайных точек вне его.
+ */
+static std::vector<Ray> randomRays(size_t count, unsigned seed) {
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<float> inside(-1.0f, 1.0f);
+  std::vector<Ray> rays(count);
+  for (Ray& ray : rays) {
+    for (int axis = 0; axis < 3; ++axis) {
+      ray.origin[axis] = 4.0f * inside(random);
+      ray.direction[axis] = inside(random) - ray.origin[axis];
+    }
+  }
+  return rays;
+}
+
+TEST(BvhTest, ClosestMatchesScan) {
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  std::uniform_int_distribution<int> offset(1, 20);
+  Model3D model;
+  for (int i = 0; i < 20000; ++i) {
+    model.addVertex(
+        Vertex(coordinate(random), coordinate(random), coordinate(random)));
+  }
+  std::vector<int> lines;
+  for (int i = 0; i + 20 < 20000; ++i) {
+    lines.push_back(i);
+    lines.push_back(i + offset(random));
+  }
+
+  Bvh bvh;
+  bvh.build(model.vertices, lines);
+  ASSERT_EQ(bvh.size(), lines.size() / 2);
+  int found = 0;
+  for (const Ray& ray : randomRays(300, 11)) {
+    BvhHit expected = Bvh::scan(model.vertices, lines, ray, 0.05f);
+    BvhHit actual = bvh.closest(model.vertices, ray, 0.05f);
+    ASSERT_EQ(actual.found, expected.found);
+    if (!expected.found) continue;
+    ++found;
+    EXPECT_NEAR(actual.distance, expected.distance, 1e-6f);
+    auto segment = bvh.segment(actual.segment);
+    EXPECT_EQ(segment[0], lines[2 * actual.segment]);
+    EXPECT_EQ(segment[1], lines[2 * actual.segment + 1]);
+  }
+  EXPECT_GT(found, 100);
+}
+
+TEST(BvhTest, PointsAndRefitAfterTransform) {
+  Model3D model = makeGrid(100);
+  Bvh points;
+  points.buildPoints(model.vertices);
+  ASSERT_EQ(points.size(), model.vertices.size());
+
+  // Луч вдоль -z через вершину (30, 40)
+  Ray ray;
+  ray.origin[0] = 30.1f, ray.origin[1] = 40.0f, ray.origin[2] = 10.0f;
+  BvhHit hit = points.closest(model.vertices, ray, 0.5f);
+  ASSERT_TRUE(hit.found);
+  EXPECT_EQ(hit.segment, 40u * 101 + 30);
+  EXPECT_NEAR(hit.distance, 0.1f, 1e-5f);
+  EXPECT_NEAR(hit.depth, 10.0f, 1e-5f);
+  EXPECT_FALSE(points.closest(model.vertices, ray, 0.05f).found);
+
+  // Вершины сдвинуты и повёрнуты: refit() без перестройки дерева
+  model.rotateModel(20, 30, 40);
+  model.shiftModel(1, 2, 3);
+  points.refit(model.vertices);
+  std::vector<int> pairs;
+  for (size_t i = 0; i < model.vertices.size(); ++i) {
+    pairs.push_back(static_cast<int>(i));
+    pairs.push_back(static_cast<int>(i));
+  }
+  for (const Ray& random : randomRays(200, 3)) {
+    Ray scaled = random;
+    for (float& value : scaled.origin) value *= 50.0f;
+    BvhHit expected = Bvh::scan(model.vertices, pairs, scaled, 1.0f);
+    BvhHit actual = points.closest(model.vertices, scaled, 1.0f);
+    ASSERT_EQ(actual.found, expected.found);
+    if (expected.found) {
+      EXPECT_NEAR(actual.distance, expected.distance, 1e-5f);
+    }
+  }
+
+  // Отложенное преобразование: луч переводится в координаты модели
+  Model3D lazy = makeGrid(100);
+  lazy.transform.rotate(0, 0, 90);
+  Ray world;
+  world.origin[0] = -40.0f, world.origin[1] = 30.0f, world.origin[2] = 10.0f;
+  Ray local = world.transformed(lazy.transform.matrix().inverse());
+  Bvh lazyPoints;
+  lazyPoints.buildPoints(lazy.vertices);
+  hit = lazyPoints.closest(lazy.vertices, local, 0.5f);
+  ASSERT_TRUE(hit.found);
+  EXPECT_EQ(hit.segment, 40u * 101 + 30);
+}
+
+TEST(BvhTest, CancelledBuildLeavesEmptyTree) {
+  Model3D model = makeGrid(100);
+  std::vector<int> lines = convertToUniqueLines(model.polygons);
+  Bvh bvh;
+  CancellationToken token;
+  ASSERT_TRUE(bvh.build(model.vertices, lines, &token));
+  ASSERT_EQ(bvh.size(), lines.size() / 2);
+
+  // Отменённое построение не оставляет ни прежнего, ни частичного дерева
+  token.cancel();
+  EXPECT_FALSE(bvh.build(model.vertices, lines, &token));
+  EXPECT_EQ(bvh.size(), 0u);
+  EXPECT_FALSE(bvh.buildPoints(model.vertices, &token));
+  EXPECT_EQ(bvh.size(), 0u);
+  Ray ray;
+  ray.origin[0] = 30.1f, ray.origin[1] = 40.0f, ray.origin[2] = 10.0f;
+  EXPECT_FALSE(bvh.closest(model.vertices, ray, 0.5f).found);
+}
+
+TEST(UniqueLinesTest, ClustersAreCompactAndKeepEdges) {
+  Model3D grid = makeGrid(100);
+  std::vector<int> lines = convertToUniqueLines(grid.polygons);
+  const size_t maxEdges = 256;
+  std::vector<LineChunk> clusters =
+      clusterLines(grid.vertices, lines, maxEdges);
+  ASSERT_EQ(clusters.size(), (lines.size() / 2 + maxEdges - 1) / maxEdges);
+
+  std::vector<std::pair<int, int>> expected, actual;
+  for (size_t i = 0; i < lines.size(); i += 2) {
+    expected.emplace_back(lines[i], lines[i + 1]);
+  }
+  float totalArea = 0;
+  for (const LineChunk& cluster : clusters) {
+    EXPECT_LE(cluster.indices.size(), 2 * maxEdges);
+    EXPECT_LE(cluster.vertices.size(), 2 * maxEdges);
+    for (size_t i = 0; i < cluster.indices.size(); i += 2) {
+      actual.emplace_back(cluster.vertices[cluster.indices[i]],
+                          cluster.vertices[cluster.indices[i + 1]]);
+    }
+    // Кластер занимает малую часть сетки 100 x 100
+    float area = (cluster.bounds.max[0] - cluster.bounds.min[0]) *
+                 (cluster.bounds.max[1] - cluster.bounds.min[1]);
+    EXPECT_LT(area, 0.15f * 100 * 100);
+    totalArea += area;
+    for (int vertex : cluster.vertices) {
+      const Vertex& v = grid.vertices[vertex];
+      EXPECT_GE(v.x, cluster.bounds.min[0]);
+      EXPECT_LE(v.x, cluster.bounds.max[0]);
+      EXPECT_GE(v.y, cluster.bounds.min[1]);
+      EXPECT_LE(v.y, cluster.bounds.max[1]);
+    }
+  }
+  // Кластеры почти не перекрываются: в сумме около площади сетки
+  EXPECT_LT(totalArea, 3.0f * 100 * 100);
+  std::sort(expected.begin(), expected.end());
+  std::sort(actual.begin(), actual.end());
+  EXPECT_EQ(actual, expected);
+
+  EXPECT_TRUE(clusterLines(grid.vertices, {}).empty());
+  EXPECT_THROW(clusterLines(grid.vertices, lines, 0), std::invalid_argument);
+  EXPECT_THROW(clusterLines(grid.vertices, {0, -1}), std::invalid_argument);
+  EXPECT_THROW(clusterLines(grid.vertices, {0, 1 << 20}),
+               std::invalid_argument);
+}
+
+TEST(FrustumTest, PerspectiveAndOrthographicCulling) {
+  auto box = [](float x, float y, float z, float half) {
+    BoundingBox result;
+    result.include(x - half, y - half, z - half);
+    result.include(x + half, y + half, z + half);
+    return result;
+  };
+
+  // Камера в (0, 0, 10) смотрит вдоль -z
+  AffineTransform cameraFromScene =
+      AffineTransform::translation(0, 0, 10).inverse();
+  Frustum perspective(60, 800, 600, cameraFromScene);
+  EXPECT_TRUE(perspective.intersects(box(0, 0, 0, 1)));
+  EXPECT_TRUE(perspective.intersects(box(7, 0, 0, 1)));  // tan 30° * 4/3
+  EXPECT_FALSE(perspective.intersects(box(10, 0, 0, 1)));
+  EXPECT_FALSE(perspective.intersects(box(0, 8, 0, 1)));
+  EXPECT_FALSE(perspective.intersects(box(0, 0, 20, 1)));  // За камерой
+  EXPECT_FALSE(perspective.intersects(BoundingBox()));
+
+  Frustum orthographic(0, 800, 600, cameraFromScene);
+  EXPECT_TRUE(orthographic.intersects(box(390, 0, 0, 1)));
+  EXPECT_FALSE(orthographic.intersects(box(500, 0, 0, 1)));
+  EXPECT_FALSE(orthographic.intersects(box(0, 310, 0, 1)));
+
+  // Бокс в координатах модели, узел масштабирован в 100 раз и повёрнут
+  AffineTransform sceneFromModel = AffineTransform::scaling(100) *
+                                   AffineTransform::rotation(0, 0, 90);
+  Frustum scaled(0, 800, 600, cameraFromScene * sceneFromModel);
+  EXPECT_TRUE(scaled.intersects(box(0, -3.5f, 0, 0.1f)));  // x = 350
+  EXPECT_FALSE(scaled.intersects(box(0, -4.5f, 0, 0.1f)));  // x = 450
+}
+
+TEST(MeshGeneratorTest, ShapesAreDeterministicAndSized) {
+  for (MeshShape shape : {MeshShape::kSphere, MeshShape::kGrid,
+                          MeshShape::kTorus, MeshShape::kSoup}) {
+    SCOPED_TRACE(MeshGenerator::shapeName(shape));
+    MeshSpec spec{shape, 5000, 42};
+    Model3D model = MeshGenerator::model(spec);
+    EXPECT_NEAR(static_cast<double>(model.polygons.size()), 5000.0, 250.0);
+    EXPECT_FALSE(model.bounds().empty());
+
+    std::string text = MeshGenerator::objText(spec);
+    EXPECT_EQ(text, MeshGenerator::objText(spec));
+    MeshSpec other = spec;
+    other.seed = 43;
+    EXPECT_NE(text, MeshGenerator::objText(other));
+  }
+
+  // Замкнутые формы: каждое ребро принадлежит ровно двум граням
+  for (MeshShape shape : {MeshShape::kSphere, MeshShape::kTorus}) {
+    Model3D model = MeshGenerator::model({shape, 2000, 1});
+    EXPECT_EQ(convertToLines(model.polygons).size(),
+              2 * convertToUniqueLines(model.polygons).size());
+  }
+
+  std::vector<size_t> sizes(9, 0);
+  Model3D soup = MeshGenerator::model({MeshShape::kSoup, 10000, 1});
+  for (PolygonView polygon : soup.polygons) ++sizes[polygon.size()];
+  EXPECT_GT(sizes[3], 4000u);
+  EXPECT_GT(sizes[4], 3000u);
+  EXPECT_GT(sizes[5] + sizes[6] + sizes[7] + sizes[8], 1000u);
+}